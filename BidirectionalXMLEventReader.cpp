@@ -0,0 +1,392 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/BidirectionalXMLEventReader.cpp
+ * @details The forward thread passes its events on to the consumer right
+ *     away, while the events of the reverse thread are kept until the
+ *     forward thread has caught up with them. The forward thread detects
+ *     the meeting point by reaching the start of the last token the reverse
+ *     thread accepted. It then continues on its own until it ends on a
+ *     token start of the reverse thread, and the reverse tokens it overlaps
+ *     are dropped. This also covers the cases where the two directions
+ *     split the input into tokens differently or where reverse lexing
+ *     failed. The input needs to be UTF-8.
+ *
+ *     Reverse lexing is slower than forward lexing, even with the input
+ *     read in blocks: about 6 MB/s compared to 13 MB/s on a 35 MB file of
+ *     short records. The halves therefore meet at about a third of the
+ *     input from its end, which makes reading about 1.4 times as fast with
+ *     two free cores, and slower with only one. All events of the reverse
+ *     half are kept in memory until the forward thread has caught up, see
+ *     setMaxReverseEvents().
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "BidirectionalXMLEventReader.h"
+#include "SpanEventReader.h"
+#include "BlockStreamBuffer.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace cpprstax
+{
+
+BidirectionalXMLEventReader::BidirectionalXMLEventReader(const std::string& strFilePath):
+  m_strFilePath(strFilePath),
+  m_nFileSize(0),
+  m_pEntityTable(new EntityTable()),
+  m_bSuppressWhitespace(false),
+  m_nMaxReverseEvents(262144),
+  m_bStarted(false),
+  m_nForwardPosition(0),
+  m_nReversePosition(0),
+  m_bMet(false),
+  m_bStop(false),
+  m_bForwardFinished(false),
+  m_bReverseFinished(false),
+  m_pException(nullptr),
+  m_nBatchPosition(0),
+  m_bForwardDrained(false),
+  m_nReverseIndex(0)
+{
+    std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    aStream.seekg(0, std::ios_base::end);
+    m_nFileSize = aStream.tellg();
+
+    if (m_nFileSize < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    m_nReversePosition.store(m_nFileSize);
+}
+
+BidirectionalXMLEventReader::~BidirectionalXMLEventReader()
+{
+    {
+        std::unique_lock<std::mutex> aLock(m_aMutex);
+
+        m_bStop.store(true);
+        m_aCondition.notify_all();
+    }
+
+    if (m_aForwardThread.joinable() == true)
+    {
+        m_aForwardThread.join();
+    }
+
+    if (m_aReverseThread.joinable() == true)
+    {
+        m_aReverseThread.join();
+    }
+
+    if (m_pException != nullptr)
+    {
+        delete m_pException;
+    }
+}
+
+bool BidirectionalXMLEventReader::hasNext()
+{
+    if (m_nBatchPosition < m_aBatch.size())
+    {
+        return true;
+    }
+
+    if (m_bForwardDrained == true)
+    {
+        return m_nReverseIndex > 0;
+    }
+
+    if (m_bStarted != true)
+    {
+        m_aForwardThread = std::thread(&BidirectionalXMLEventReader::Forward, this);
+        m_aReverseThread = std::thread(&BidirectionalXMLEventReader::Reverse, this);
+        m_bStarted = true;
+    }
+
+    {
+        std::unique_lock<std::mutex> aLock(m_aMutex);
+
+        while (m_aForwardBatches.empty() == true &&
+               m_bForwardFinished != true)
+        {
+            m_aCondition.wait(aLock);
+        }
+
+        if (m_aForwardBatches.empty() != true)
+        {
+            m_aBatch.swap(m_aForwardBatches.front());
+            m_aForwardBatches.pop_front();
+            m_nBatchPosition = 0;
+            m_aCondition.notify_all();
+            return true;
+        }
+
+        m_bStop.store(true);
+    }
+
+    m_aForwardThread.join();
+    m_aReverseThread.join();
+
+    if (m_pException != nullptr)
+    {
+        std::exception* pException(m_pException);
+        m_pException = nullptr;
+        throw pException;
+    }
+
+    m_bForwardDrained = true;
+    m_nReverseIndex = m_aReverseEvents.size();
+
+    return m_nReverseIndex > 0;
+}
+
+std::unique_ptr<XMLEvent> BidirectionalXMLEventReader::nextEvent()
+{
+    if (hasNext() != true)
+    {
+        throw new std::logic_error("Attempted BidirectionalXMLEventReader::nextEvent() while there isn't one instead of checking BidirectionalXMLEventReader::hasNext() first.");
+    }
+
+    if (m_nBatchPosition < m_aBatch.size())
+    {
+        return std::move(m_aBatch[m_nBatchPosition++]);
+    }
+
+    return std::move(m_aReverseEvents[--m_nReverseIndex]);
+}
+
+int BidirectionalXMLEventReader::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+{
+    return m_pEntityTable->add(strName, strReplacementText);
+}
+
+void BidirectionalXMLEventReader::setSuppressWhitespace(const bool& bSuppress)
+{
+    m_bSuppressWhitespace = bSuppress;
+}
+
+/**
+ * @brief Limits the events the reverse thread keeps until the forward thread
+ *     catches up with them, 262144 by default. With short text, an event
+ *     takes about 200 bytes, so that's about 50 MiB. Once reached, the
+ *     reverse thread stops and the forward thread lexes the rest on its own.
+ */
+void BidirectionalXMLEventReader::setMaxReverseEvents(const std::size_t& nMaxEvents)
+{
+    m_nMaxReverseEvents = nMaxEvents;
+}
+
+/**
+ * @brief Thread function.
+ */
+void BidirectionalXMLEventReader::Forward()
+{
+    try
+    {
+        std::ifstream aFile(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+        if (aFile.is_open() != true)
+        {
+            throw new std::runtime_error("Couldn't open input file.");
+        }
+
+        // The position is asked for after every token, which std::filebuf
+        // passes on to the file.
+        BlockStreamBuffer aBuffer(aFile);
+        std::istream aStream(&aBuffer);
+
+        SpanEventReader aReader(aStream, m_nFileSize);
+
+        aReader.setSuppressWhitespace(m_bSuppressWhitespace);
+
+        aReader.setEntityTable(m_pEntityTable);
+
+        std::vector<std::unique_ptr<XMLEvent>> aBatch;
+        bool bMet(false);
+
+        while (m_bStop.load() != true)
+        {
+            std::streamoff nEnd(0);
+            bool bToken(aReader.lexNext(aBatch, nEnd));
+
+            m_nForwardPosition.store(nEnd);
+
+            if (bMet != true &&
+                nEnd >= m_nReversePosition.load())
+            {
+                bMet = true;
+                m_bMet.store(true);
+            }
+
+            if (bMet == true)
+            {
+                std::unique_lock<std::mutex> aLock(m_aMutex);
+
+                while (m_bReverseFinished != true)
+                {
+                    m_aCondition.wait(aLock);
+                }
+
+                while (m_aReverseTokens.empty() != true &&
+                       m_aReverseTokens.back().nBegin < nEnd)
+                {
+                    m_aReverseEvents.erase(m_aReverseEvents.begin() + m_aReverseTokens.back().nEventIndex,
+                                           m_aReverseEvents.end());
+                    m_aReverseTokens.pop_back();
+                }
+
+                if (m_aReverseTokens.empty() == true ||
+                    m_aReverseTokens.back().nBegin == nEnd)
+                {
+                    // Either the rest of the input is covered by reverse
+                    // tokens or there's nothing left.
+                    if (m_aReverseTokens.empty() != true ||
+                        bToken != true)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if (bToken != true)
+            {
+                break;
+            }
+
+            if (aBatch.size() >= 256)
+            {
+                Publish(aBatch);
+            }
+        }
+
+        if (aBatch.empty() != true)
+        {
+            Publish(aBatch);
+        }
+    }
+    catch (std::exception* pException)
+    {
+        std::unique_lock<std::mutex> aLock(m_aMutex);
+
+        m_pException = pException;
+    }
+
+    std::unique_lock<std::mutex> aLock(m_aMutex);
+
+    m_bMet.store(true);
+    m_bForwardFinished = true;
+    m_aCondition.notify_all();
+}
+
+/**
+ * @brief Thread function.
+ */
+void BidirectionalXMLEventReader::Reverse()
+{
+    std::size_t nEventIndex(0);
+
+    try
+    {
+        std::ifstream aFile(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+        if (aFile.is_open() != true)
+        {
+            throw new std::runtime_error("Couldn't open input file.");
+        }
+
+        // Reading backwards seeks for every byte, which std::filebuf
+        // passes on to the file.
+        BlockStreamBuffer aBuffer(aFile);
+        std::istream aStream(&aBuffer);
+
+        aStream.seekg(0, std::ios_base::end);
+
+        SpanEventReader aReader(aStream, m_nFileSize);
+
+        aReader.setSuppressWhitespace(m_bSuppressWhitespace);
+
+        aReader.setEntityTable(m_pEntityTable);
+
+        while (m_bStop.load() != true &&
+               m_bMet.load() != true &&
+               m_aReverseEvents.size() < m_nMaxReverseEvents)
+        {
+            std::streamoff nBegin(0);
+
+            nEventIndex = m_aReverseEvents.size();
+
+            if (aReader.lexPrevious(m_aReverseEvents, nBegin) != true)
+            {
+                break;
+            }
+
+            if (nBegin < m_nForwardPosition.load())
+            {
+                m_aReverseEvents.erase(m_aReverseEvents.begin() + nEventIndex, m_aReverseEvents.end());
+                break;
+            }
+
+            ReverseToken aToken = { nBegin, nEventIndex };
+            m_aReverseTokens.push_back(aToken);
+            m_nReversePosition.store(nBegin);
+        }
+    }
+    catch (std::exception* pException)
+    {
+        // The forward thread lexes what's left, and reports the error if
+        // there is one.
+        delete pException;
+
+        m_aReverseEvents.erase(m_aReverseEvents.begin() + nEventIndex, m_aReverseEvents.end());
+    }
+
+    std::unique_lock<std::mutex> aLock(m_aMutex);
+
+    m_bReverseFinished = true;
+    m_aCondition.notify_all();
+}
+
+/**
+ * @brief Hands a batch of forward events to the consumer, waiting while
+ *     the consumer is far behind.
+ */
+void BidirectionalXMLEventReader::Publish(std::vector<std::unique_ptr<XMLEvent>>& aBatch)
+{
+    std::unique_lock<std::mutex> aLock(m_aMutex);
+
+    while (m_aForwardBatches.size() >= 64 &&
+           m_bStop.load() != true)
+    {
+        m_aCondition.wait(aLock);
+    }
+
+    m_aForwardBatches.push_back(std::move(aBatch));
+    aBatch.clear();
+    m_aCondition.notify_all();
+}
+
+}
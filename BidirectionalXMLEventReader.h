@@ -0,0 +1,108 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/BidirectionalXMLEventReader.h
+ * @brief Forward reading of a whole file, with one thread lexing from the
+ *     start and another one backwards from the end until they meet.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_BIDIRECTIONALXMLEVENTREADER_H
+#define _CPPRSTAX_BIDIRECTIONALXMLEVENTREADER_H
+
+#include "XMLEvent.h"
+#include "EntityTable.h"
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace cpprstax
+{
+
+class BidirectionalXMLEventReader
+{
+public:
+    BidirectionalXMLEventReader(const std::string& strFilePath);
+    ~BidirectionalXMLEventReader();
+
+    bool hasNext();
+    std::unique_ptr<XMLEvent> nextEvent();
+
+public:
+    int addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText);
+    void setSuppressWhitespace(const bool& bSuppress);
+    void setMaxReverseEvents(const std::size_t& nMaxEvents);
+
+protected:
+    struct ReverseToken
+    {
+        std::streamoff nBegin;
+        /** Index of the first event of the token in m_aReverseEvents. */
+        std::size_t nEventIndex;
+    };
+
+protected:
+    void Forward();
+    void Reverse();
+    void Publish(std::vector<std::unique_ptr<XMLEvent>>& aBatch);
+
+protected:
+    std::string m_strFilePath;
+    std::streamoff m_nFileSize;
+    std::shared_ptr<EntityTable> m_pEntityTable;
+    bool m_bSuppressWhitespace;
+    std::size_t m_nMaxReverseEvents;
+
+    std::thread m_aForwardThread;
+    std::thread m_aReverseThread;
+    bool m_bStarted;
+
+    /** End of the tokens lexed by the forward thread. */
+    std::atomic<std::streamoff> m_nForwardPosition;
+    /** Start of the tokens accepted from the reverse thread. */
+    std::atomic<std::streamoff> m_nReversePosition;
+    std::atomic<bool> m_bMet;
+    std::atomic<bool> m_bStop;
+
+    std::mutex m_aMutex;
+    std::condition_variable m_aCondition;
+    std::deque<std::vector<std::unique_ptr<XMLEvent>>> m_aForwardBatches;
+    bool m_bForwardFinished;
+    bool m_bReverseFinished;
+    /** In the order the reverse thread lexed them. */
+    std::vector<std::unique_ptr<XMLEvent>> m_aReverseEvents;
+    std::vector<ReverseToken> m_aReverseTokens;
+    std::exception* m_pException;
+
+    // Consumer side.
+    std::vector<std::unique_ptr<XMLEvent>> m_aBatch;
+    std::size_t m_nBatchPosition;
+    bool m_bForwardDrained;
+    std::size_t m_nReverseIndex;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,178 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/BlockStreamBuffer.cpp
+ * @details Blocks are aligned to multiples of their size, so reading
+ *     backwards over a block boundary loads the whole previous block.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "BlockStreamBuffer.h"
+#include <stdexcept>
+
+namespace cpprstax
+{
+
+/**
+ * @brief Amount of source bytes read at once.
+ */
+const std::streamoff BLOCK_SIZE = 65536;
+
+
+
+BlockStreamBuffer::BlockStreamBuffer(std::istream& aSource):
+  m_aSource(aSource),
+  m_nSourceBegin(aSource.tellg()),
+  m_nSourceLength(0),
+  m_aBuffer(BLOCK_SIZE),
+  m_nBufferOffset(0)
+{
+    if (m_nSourceBegin < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    m_aSource.seekg(0, std::ios_base::end);
+    std::streampos nSourceEnd(m_aSource.tellg());
+
+    if (m_aSource.fail() == true ||
+        nSourceEnd < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    m_nSourceLength = nSourceEnd - m_nSourceBegin;
+
+    char* pBuffer(m_aBuffer.data());
+    setg(pBuffer, pBuffer, pBuffer);
+}
+
+BlockStreamBuffer::int_type BlockStreamBuffer::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamoff nPosition(m_nBufferOffset + (egptr() - eback()));
+
+    if (nPosition >= m_nSourceLength)
+    {
+        return traits_type::eof();
+    }
+
+    LoadBlock(nPosition);
+    setg(eback(), eback() + (nPosition - m_nBufferOffset), egptr());
+
+    return traits_type::to_int_type(*gptr());
+}
+
+BlockStreamBuffer::int_type BlockStreamBuffer::pbackfail(int_type c)
+{
+    std::streamoff nPosition(m_nBufferOffset + (gptr() - eback()));
+
+    if (nPosition <= 0)
+    {
+        return traits_type::eof();
+    }
+
+    seekpos(nPosition - 1, std::ios_base::in);
+
+    if (traits_type::eq_int_type(c, traits_type::eof()) != true &&
+        traits_type::eq_int_type(c, traits_type::to_int_type(*gptr())) != true)
+    {
+        // Putting back a different character isn't supported.
+        gbump(1);
+        return traits_type::eof();
+    }
+
+    return traits_type::to_int_type(*gptr());
+}
+
+BlockStreamBuffer::pos_type BlockStreamBuffer::seekoff(off_type nOffset, std::ios_base::seekdir eDirection, std::ios_base::openmode nMode)
+{
+    std::streamoff nTarget(nOffset);
+
+    if (eDirection == std::ios_base::cur)
+    {
+        nTarget += m_nBufferOffset + (gptr() - eback());
+    }
+    else if (eDirection == std::ios_base::end)
+    {
+        nTarget += m_nSourceLength;
+    }
+
+    return seekpos(pos_type(nTarget), nMode);
+}
+
+BlockStreamBuffer::pos_type BlockStreamBuffer::seekpos(pos_type nPosition, std::ios_base::openmode nMode)
+{
+    std::streamoff nTarget(nPosition);
+
+    if ((nMode & std::ios_base::in) == 0 ||
+        nTarget < 0 ||
+        nTarget > m_nSourceLength)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    // Stays within the current block, which is the common
+    // case for tellg() and XMLEventReader::rget().
+    if (nTarget < m_nBufferOffset ||
+        nTarget > m_nBufferOffset + (egptr() - eback()))
+    {
+        LoadBlock(nTarget);
+    }
+
+    setg(eback(), eback() + (nTarget - m_nBufferOffset), egptr());
+
+    return nPosition;
+}
+
+/**
+ * @brief Loads the block that contains nOffset.
+ */
+void BlockStreamBuffer::LoadBlock(const std::streamoff& nOffset)
+{
+    std::streamoff nBlockOffset(nOffset - (nOffset % BLOCK_SIZE));
+
+    m_aSource.clear();
+    m_aSource.seekg(m_nSourceBegin + nBlockOffset);
+
+    if (m_aSource.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    m_aSource.read(m_aBuffer.data(), m_aBuffer.size());
+
+    if (m_aSource.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+
+    std::size_t nCount(m_aSource.gcount());
+
+    m_aSource.clear();
+
+    char* pBuffer(m_aBuffer.data());
+    setg(pBuffer, pBuffer, pBuffer + nCount);
+    m_nBufferOffset = nBlockOffset;
+}
+
+}
@@ -0,0 +1,61 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/BlockStreamBuffer.h
+ * @brief Input stage that reads a seekable source in blocks, so seeking
+ *     within a block, as done for every byte in reverse direction, doesn't
+ *     reach the source.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_BLOCKSTREAMBUFFER_H
+#define _CPPRSTAX_BLOCKSTREAMBUFFER_H
+
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+namespace cpprstax
+{
+
+class BlockStreamBuffer : public std::streambuf
+{
+public:
+    BlockStreamBuffer(std::istream& aSource);
+
+protected:
+    virtual int_type underflow();
+    virtual int_type pbackfail(int_type c);
+    virtual pos_type seekoff(off_type nOffset, std::ios_base::seekdir eDirection, std::ios_base::openmode nMode);
+    virtual pos_type seekpos(pos_type nPosition, std::ios_base::openmode nMode);
+
+protected:
+    void LoadBlock(const std::streamoff& nOffset);
+
+protected:
+    std::istream& m_aSource;
+    std::streampos m_nSourceBegin;
+    std::streamoff m_nSourceLength;
+    std::vector<char> m_aBuffer;
+    std::streamoff m_nBufferOffset;
+
+};
+
+}
+
+#endif
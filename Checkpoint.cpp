@@ -0,0 +1,196 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/Checkpoint.cpp
+ * @details The file starts with the magic "CRSXCKP1" and the position,
+ *     followed by the open elements and the entities. Numbers are little
+ *     endian, strings are preceded by their length of 4 bytes.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "Checkpoint.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace cpprstax
+{
+
+static const char g_aMagic[] = { 'C', 'R', 'S', 'X', 'C', 'K', 'P', '1' };
+
+Checkpoint::Checkpoint():
+  m_nPosition(0)
+{
+
+}
+
+/**
+ * @brief Reads a checkpoint written by write().
+ */
+Checkpoint::Checkpoint(std::istream& aStream):
+  m_nPosition(0)
+{
+    char aMagic[sizeof(g_aMagic)];
+
+    aStream.read(aMagic, sizeof(aMagic));
+
+    if (aStream.gcount() != static_cast<std::streamsize>(sizeof(aMagic)))
+    {
+        throw new std::runtime_error("Checkpoint incomplete.");
+    }
+
+    if (std::memcmp(aMagic, g_aMagic, sizeof(g_aMagic)) != 0)
+    {
+        throw new std::runtime_error("Not a checkpoint.");
+    }
+
+    m_nPosition = ReadNumber(aStream, 8);
+
+    for (std::uint64_t i = 0, nCount = ReadNumber(aStream, 4); i < nCount; i++)
+    {
+        Element aElement;
+
+        aElement.strName = ReadString(aStream);
+
+        for (std::uint64_t j = 0, nNamespaceCount = ReadNumber(aStream, 4); j < nNamespaceCount; j++)
+        {
+            std::string strPrefix(ReadString(aStream));
+            aElement.aNamespaces.push_back(std::pair<std::string, std::string>(strPrefix, ReadString(aStream)));
+        }
+
+        m_aElements.push_back(aElement);
+    }
+
+    for (std::uint64_t i = 0, nCount = ReadNumber(aStream, 4); i < nCount; i++)
+    {
+        std::string strName(ReadString(aStream));
+        m_aEntities[strName] = ReadString(aStream);
+    }
+}
+
+void Checkpoint::write(std::ostream& aStream) const
+{
+    aStream.write(g_aMagic, sizeof(g_aMagic));
+
+    WriteNumber(aStream, m_nPosition, 8);
+    WriteNumber(aStream, m_aElements.size(), 4);
+
+    for (std::vector<Element>::const_iterator iter = m_aElements.begin();
+         iter != m_aElements.end();
+         iter++)
+    {
+        WriteString(aStream, iter->strName);
+        WriteNumber(aStream, iter->aNamespaces.size(), 4);
+
+        for (std::vector<std::pair<std::string, std::string>>::const_iterator iterNamespace = iter->aNamespaces.begin();
+             iterNamespace != iter->aNamespaces.end();
+             iterNamespace++)
+        {
+            WriteString(aStream, iterNamespace->first);
+            WriteString(aStream, iterNamespace->second);
+        }
+    }
+
+    WriteNumber(aStream, m_aEntities.size(), 4);
+
+    for (std::map<std::string, std::string>::const_iterator iter = m_aEntities.begin();
+         iter != m_aEntities.end();
+         iter++)
+    {
+        WriteString(aStream, iter->first);
+        WriteString(aStream, iter->second);
+    }
+
+    if (aStream.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+}
+
+std::streamoff Checkpoint::getPosition() const
+{
+    return m_nPosition;
+}
+
+const std::vector<Checkpoint::Element>& Checkpoint::getElements() const
+{
+    return m_aElements;
+}
+
+const std::map<std::string, std::string>& Checkpoint::getEntities() const
+{
+    return m_aEntities;
+}
+
+void Checkpoint::WriteNumber(std::ostream& aStream, std::uint64_t nNumber, const std::size_t& nSize)
+{
+    char aData[8];
+
+    for (std::size_t i = 0; i < nSize; i++)
+    {
+        aData[i] = static_cast<char>(nNumber & 0xFF);
+        nNumber >>= 8;
+    }
+
+    aStream.write(aData, nSize);
+}
+
+std::uint64_t Checkpoint::ReadNumber(std::istream& aStream, const std::size_t& nSize)
+{
+    char aData[8];
+
+    aStream.read(aData, nSize);
+
+    if (aStream.gcount() != static_cast<std::streamsize>(nSize))
+    {
+        throw new std::runtime_error("Checkpoint incomplete.");
+    }
+
+    std::uint64_t nNumber(0);
+
+    for (std::size_t i = nSize; i > 0; i--)
+    {
+        nNumber = (nNumber << 8) | static_cast<unsigned char>(aData[i - 1]);
+    }
+
+    return nNumber;
+}
+
+void Checkpoint::WriteString(std::ostream& aStream, const std::string& strText)
+{
+    WriteNumber(aStream, strText.length(), 4);
+    aStream.write(strText.data(), strText.length());
+}
+
+std::string Checkpoint::ReadString(std::istream& aStream)
+{
+    std::string strText(ReadNumber(aStream, 4), '\0');
+
+    if (strText.empty() != true)
+    {
+        aStream.read(&strText[0], strText.length());
+
+        if (aStream.gcount() != static_cast<std::streamsize>(strText.length()))
+        {
+            throw new std::runtime_error("Checkpoint incomplete.");
+        }
+    }
+
+    return strText;
+}
+
+}
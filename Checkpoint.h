@@ -0,0 +1,83 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/Checkpoint.h
+ * @brief State of an XMLEventReader at a token boundary, which can be
+ *     written to a file and read back to resume reading in another process.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_CHECKPOINT_H
+#define _CPPRSTAX_CHECKPOINT_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+
+namespace cpprstax
+{
+
+class Checkpoint
+{
+friend class XMLEventReader;
+
+public:
+    struct Element
+    {
+        /** Name with prefix, if any. */
+        std::string strName;
+        /** Namespace declarations of the start tag, prefix to URI, with an
+          * empty prefix for the default namespace. */
+        std::vector<std::pair<std::string, std::string>> aNamespaces;
+    };
+
+public:
+    Checkpoint(std::istream& aStream);
+
+public:
+    void write(std::ostream& aStream) const;
+
+    std::streamoff getPosition() const;
+    /** Elements open at the position, the root element first. */
+    const std::vector<Element>& getElements() const;
+    /** Entities added with XMLEventReader::addToEntityReplacementDictionary(). */
+    const std::map<std::string, std::string>& getEntities() const;
+
+protected:
+    Checkpoint();
+
+protected:
+    static void WriteNumber(std::ostream& aStream, std::uint64_t nNumber, const std::size_t& nSize);
+    static std::uint64_t ReadNumber(std::istream& aStream, const std::size_t& nSize);
+    static void WriteString(std::ostream& aStream, const std::string& strText);
+    static std::string ReadString(std::istream& aStream);
+
+protected:
+    std::streamoff m_nPosition;
+    std::vector<Element> m_aElements;
+    std::map<std::string, std::string> m_aEntities;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,532 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/ColumnExtractor.cpp
+ * @details The values of a record are collected as strings, which keep their
+ *     capacity from record to record, and are converted into the columns when
+ *     the record ends. Numbers are parsed in the classic "C" locale, so the
+ *     decimal separator is always '.'. Subtrees of a record that don't contain any field are
+ *     skipped with XMLEventReader::skipElement().
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "ColumnExtractor.h"
+#include "Attribute.h"
+#include "Characters.h"
+#include <stdexcept>
+#include <sstream>
+#include <list>
+#include <limits>
+#include <algorithm>
+#include <locale>
+#include <cctype>
+
+namespace cpprstax
+{
+
+ColumnExtractor::ColumnExtractor(const std::string& strRecordName, const std::size_t& nBatchSize):
+  m_strRecordName(strRecordName),
+  m_nBatchSize(nBatchSize)
+{
+    if (m_strRecordName.empty() == true)
+    {
+        throw new std::invalid_argument("Empty record name passed.");
+    }
+
+    if (m_nBatchSize <= 0)
+    {
+        throw new std::invalid_argument("Batch size needs to be positive.");
+    }
+
+    m_aNumberStream.imbue(std::locale::classic());
+}
+
+/**
+ * @param[in] strName Name of the column.
+ * @param[in] strPath Relative to the record element, like "title",
+ *     "author/name", "@id" or "link/@href". Element and attribute names
+ *     with prefix, if any. Only the first occurrence in a record is taken.
+ *     The text of an element includes the text of all elements below it.
+ * @retval Index of the column in Batch::aColumns.
+ */
+std::size_t ColumnExtractor::addField(const std::string& strName, const std::string& strPath, const ColumnType& eType)
+{
+    if (strPath.empty() == true)
+    {
+        throw new std::invalid_argument("Empty field path passed.");
+    }
+
+    Field aField;
+    aField.eType = eType;
+
+    std::size_t nBegin(0);
+
+    while (nBegin <= strPath.length())
+    {
+        std::size_t nEnd(strPath.find('/', nBegin));
+
+        if (nEnd == std::string::npos)
+        {
+            nEnd = strPath.length();
+        }
+
+        if (nEnd <= nBegin)
+        {
+            throw new std::invalid_argument("Field path with empty step.");
+        }
+
+        if (aField.strAttribute.empty() != true)
+        {
+            throw new std::invalid_argument("Field path continues after an attribute.");
+        }
+
+        if (strPath.at(nBegin) == '@')
+        {
+            if (nEnd - nBegin <= 1)
+            {
+                throw new std::invalid_argument("Field path with empty attribute name.");
+            }
+
+            aField.strAttribute = strPath.substr(nBegin + 1, nEnd - nBegin - 1);
+        }
+        else
+        {
+            aField.aPath.push_back(strPath.substr(nBegin, nEnd - nBegin));
+        }
+
+        nBegin = nEnd + 1;
+    }
+
+    if (aField.aPath.empty() == true &&
+        aField.strAttribute.empty() == true)
+    {
+        throw new std::invalid_argument("Field path doesn't select anything.");
+    }
+
+    m_aFields.push_back(aField);
+    m_aNames.push_back(strName);
+
+    return m_aFields.size() - 1;
+}
+
+/**
+ * @brief Reads all records from the current position of aReader. Record
+ *     elements below a record element are treated like any other element.
+ * @param[in] aHandler Called with every batch of up to nBatchSize records,
+ *     which is only valid during the call.
+ * @retval Number of records.
+ */
+std::size_t ColumnExtractor::run(XMLEventReader& aReader, const BatchHandler& aHandler)
+{
+    if (m_aFields.empty() == true)
+    {
+        throw new std::logic_error("No fields to extract.");
+    }
+
+    Batch aBatch;
+    aBatch.nFirstRecord = 0;
+    aBatch.aColumns.resize(m_aFields.size());
+
+    for (std::size_t i = 0; i < m_aFields.size(); i++)
+    {
+        aBatch.aColumns[i].strName = m_aNames[i];
+        aBatch.aColumns[i].eType = m_aFields[i].eType;
+    }
+
+    ClearBatch(aBatch);
+
+    m_aValues.resize(m_aFields.size());
+    m_aFound.resize(m_aFields.size());
+    m_aCollecting.clear();
+
+    std::vector<std::string> aPath;
+    bool bInRecord(false);
+    std::size_t nRecordCount(0);
+
+    while (aReader.hasNext() == true)
+    {
+        std::unique_ptr<XMLEvent> pEvent(aReader.nextEvent());
+
+        if (pEvent->isStartElement() == true)
+        {
+            StartElement& aStartElement(pEvent->asStartElement());
+
+            if (bInRecord != true)
+            {
+                if (GetName(aStartElement.getName()) != m_strRecordName)
+                {
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < m_aFields.size(); i++)
+                {
+                    m_aValues[i].clear();
+                    m_aFound[i] = false;
+                }
+
+                bInRecord = true;
+                HandleStartElement(aStartElement, aPath);
+
+                continue;
+            }
+
+            aPath.push_back(GetName(aStartElement.getName()));
+
+            if (m_aCollecting.empty() == true &&
+                IsPathPrefix(aPath) != true)
+            {
+                aReader.skipElement();
+                aPath.pop_back();
+
+                continue;
+            }
+
+            HandleStartElement(aStartElement, aPath);
+        }
+        else if (pEvent->isEndElement() == true)
+        {
+            if (bInRecord != true)
+            {
+                continue;
+            }
+
+            while (m_aCollecting.empty() != true &&
+                   m_aCollecting.back().second >= aPath.size())
+            {
+                m_aCollecting.pop_back();
+            }
+
+            if (aPath.empty() != true)
+            {
+                aPath.pop_back();
+                continue;
+            }
+
+            EndRecord(aBatch);
+            bInRecord = false;
+            ++nRecordCount;
+
+            if (aBatch.nRecords >= m_nBatchSize)
+            {
+                aHandler(aBatch);
+
+                aBatch.nFirstRecord += aBatch.nRecords;
+                ClearBatch(aBatch);
+            }
+        }
+        else if (pEvent->isCharacters() == true)
+        {
+            for (std::vector<std::pair<std::size_t, std::size_t>>::const_iterator iter = m_aCollecting.begin();
+                 iter != m_aCollecting.end();
+                 iter++)
+            {
+                m_aValues[iter->first].append(pEvent->asCharacters().getData());
+            }
+        }
+    }
+
+    if (bInRecord == true)
+    {
+        throw new std::runtime_error("Input ended within a record.");
+    }
+
+    if (aBatch.nRecords > 0)
+    {
+        aHandler(aBatch);
+    }
+
+    return nRecordCount;
+}
+
+/**
+ * @brief Writes the records of aBatch as comma-separated values, with empty
+ *     values for null and strings quoted if they contain a delimiter, quote
+ *     or line break.
+ */
+void ColumnExtractor::writeCSV(std::ostream& aStream, const Batch& aBatch, const bool& bHeader)
+{
+    if (bHeader == true)
+    {
+        for (std::size_t i = 0; i < aBatch.aColumns.size(); i++)
+        {
+            if (i > 0)
+            {
+                aStream << ',';
+            }
+
+            WriteCSVString(aStream, aBatch.aColumns[i].strName.data(), aBatch.aColumns[i].strName.length());
+        }
+
+        aStream << '\n';
+    }
+
+    std::streamsize nPrecision(aStream.precision(std::numeric_limits<double>::max_digits10));
+
+    for (std::size_t nRecord = 0; nRecord < aBatch.nRecords; nRecord++)
+    {
+        for (std::size_t i = 0; i < aBatch.aColumns.size(); i++)
+        {
+            const Column& aColumn(aBatch.aColumns[i]);
+
+            if (i > 0)
+            {
+                aStream << ',';
+            }
+
+            if (aColumn.aNull[nRecord] != 0)
+            {
+                continue;
+            }
+
+            switch (aColumn.eType)
+            {
+            case COLUMN_INT64:
+                aStream << aColumn.aInt64[nRecord];
+                break;
+            case COLUMN_DOUBLE:
+                aStream << aColumn.aDouble[nRecord];
+                break;
+            case COLUMN_STRING:
+                WriteCSVString(aStream,
+                               aColumn.aData.data() + aColumn.aOffsets[nRecord],
+                               aColumn.aOffsets[nRecord + 1] - aColumn.aOffsets[nRecord]);
+                break;
+            }
+        }
+
+        aStream << '\n';
+    }
+
+    aStream.precision(nPrecision);
+
+    if (aStream.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+}
+
+/**
+ * @param[in] aPath Element names from below the record element to
+ *     aStartElement, empty for the record element itself.
+ */
+void ColumnExtractor::HandleStartElement(StartElement& aStartElement, const std::vector<std::string>& aPath)
+{
+    for (std::size_t i = 0; i < m_aFields.size(); i++)
+    {
+        const Field& aField(m_aFields[i]);
+
+        if (m_aFound[i] == true ||
+            aField.aPath != aPath)
+        {
+            continue;
+        }
+
+        if (aField.strAttribute.empty() == true)
+        {
+            m_aFound[i] = true;
+            m_aCollecting.push_back(std::pair<std::size_t, std::size_t>(i, aPath.size()));
+            continue;
+        }
+
+        const std::shared_ptr<std::list<std::shared_ptr<Attribute>>> pAttributes(aStartElement.getAttributes());
+
+        for (std::list<std::shared_ptr<Attribute>>::const_iterator iter = pAttributes->begin();
+             iter != pAttributes->end();
+             iter++)
+        {
+            if (GetName((*iter)->getName()) == aField.strAttribute)
+            {
+                m_aValues[i] = (*iter)->getValue();
+                m_aFound[i] = true;
+                break;
+            }
+        }
+    }
+}
+
+void ColumnExtractor::EndRecord(Batch& aBatch)
+{
+    for (std::size_t i = 0; i < m_aFields.size(); i++)
+    {
+        Column& aColumn(aBatch.aColumns[i]);
+        const std::string& strValue(m_aValues[i]);
+
+        if (aColumn.eType == COLUMN_STRING)
+        {
+            aColumn.aNull.push_back(m_aFound[i] == true ? 0 : 1);
+            aColumn.aData.insert(aColumn.aData.end(), strValue.begin(), strValue.end());
+            aColumn.aOffsets.push_back(aColumn.aData.size());
+
+            continue;
+        }
+
+        const char* pBegin(strValue.c_str());
+
+        while (*pBegin != '\0' &&
+               std::isspace(static_cast<unsigned char>(*pBegin)) != 0)
+        {
+            ++pBegin;
+        }
+
+        if (*pBegin == '\0')
+        {
+            aColumn.aNull.push_back(1);
+
+            if (aColumn.eType == COLUMN_INT64)
+            {
+                aColumn.aInt64.push_back(0);
+            }
+            else
+            {
+                aColumn.aDouble.push_back(0.0);
+            }
+
+            continue;
+        }
+
+        m_aNumberStream.clear();
+        m_aNumberStream.str(strValue);
+
+        if (aColumn.eType == COLUMN_INT64)
+        {
+            long long nValue(0);
+
+            m_aNumberStream >> nValue;
+            aColumn.aInt64.push_back(nValue);
+        }
+        else
+        {
+            double fValue(0.0);
+
+            m_aNumberStream >> fValue;
+            aColumn.aDouble.push_back(fValue);
+        }
+
+        // Fails on overflow, but not for subnormal numbers.
+        if (m_aNumberStream.good() == true)
+        {
+            m_aNumberStream >> std::ws;
+        }
+
+        if (m_aNumberStream.fail() == true ||
+            m_aNumberStream.eof() != true)
+        {
+            std::stringstream aMessage;
+            aMessage << "Value '" << strValue << "' of field '" << aColumn.strName << "' in record "
+                     << (aBatch.nFirstRecord + aBatch.nRecords) << " isn't a valid "
+                     << (aColumn.eType == COLUMN_INT64 ? "64-bit integer" : "number") << ".";
+            throw new std::runtime_error(aMessage.str());
+        }
+
+        aColumn.aNull.push_back(0);
+    }
+
+    ++aBatch.nRecords;
+}
+
+/**
+ * @brief Empties the columns, keeping the memory allocated for them.
+ */
+void ColumnExtractor::ClearBatch(Batch& aBatch)
+{
+    aBatch.nRecords = 0;
+
+    for (std::vector<Column>::iterator iter = aBatch.aColumns.begin();
+         iter != aBatch.aColumns.end();
+         iter++)
+    {
+        iter->aNull.clear();
+        iter->aInt64.clear();
+        iter->aDouble.clear();
+        iter->aOffsets.clear();
+        iter->aData.clear();
+
+        if (iter->eType == COLUMN_STRING)
+        {
+            iter->aOffsets.push_back(0);
+        }
+    }
+}
+
+/**
+ * @retval true if a field is at or below aPath.
+ */
+bool ColumnExtractor::IsPathPrefix(const std::vector<std::string>& aPath)
+{
+    for (std::vector<Field>::const_iterator iter = m_aFields.begin();
+         iter != m_aFields.end();
+         iter++)
+    {
+        if (iter->aPath.size() >= aPath.size() &&
+            std::equal(aPath.begin(), aPath.end(), iter->aPath.begin()) == true)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string ColumnExtractor::GetName(const QName& aName)
+{
+    if (aName.getPrefix().empty() == true)
+    {
+        return aName.getLocalPart();
+    }
+
+    return aName.getPrefix() + ":" + aName.getLocalPart();
+}
+
+void ColumnExtractor::WriteCSVString(std::ostream& aStream, const char* pData, const std::size_t& nLength)
+{
+    bool bQuote(false);
+
+    for (std::size_t i = 0; i < nLength; i++)
+    {
+        if (pData[i] == ',' ||
+            pData[i] == '"' ||
+            pData[i] == '\n' ||
+            pData[i] == '\r')
+        {
+            bQuote = true;
+            break;
+        }
+    }
+
+    if (bQuote != true)
+    {
+        aStream.write(pData, nLength);
+        return;
+    }
+
+    aStream << '"';
+
+    for (std::size_t i = 0; i < nLength; i++)
+    {
+        if (pData[i] == '"')
+        {
+            aStream << '"';
+        }
+
+        aStream << pData[i];
+    }
+
+    aStream << '"';
+}
+
+}
@@ -0,0 +1,125 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/ColumnExtractor.h
+ * @brief Converts repeated record elements into typed columns, in batches
+ *     of a fixed number of records.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_COLUMNEXTRACTOR_H
+#define _CPPRSTAX_COLUMNEXTRACTOR_H
+
+#include "XMLEventReader.h"
+#include "XMLEvent.h"
+#include "StartElement.h"
+#include "QName.h"
+#include <ostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace cpprstax
+{
+
+class ColumnExtractor
+{
+public:
+    enum ColumnType
+    {
+        COLUMN_INT64,
+        COLUMN_DOUBLE,
+        COLUMN_STRING
+    };
+
+    /**
+     * @brief Values of one field for the records of a batch. Only the
+     *     vectors of the column's type are filled.
+     */
+    struct Column
+    {
+        std::string strName;
+        ColumnType eType;
+        /** 1 for records in which the field is missing or, for numbers,
+          * empty. */
+        std::vector<std::uint8_t> aNull;
+        std::vector<std::int64_t> aInt64;
+        std::vector<double> aDouble;
+        /** The string of record i is aData[aOffsets[i], aOffsets[i + 1]). */
+        std::vector<std::uint64_t> aOffsets;
+        std::vector<char> aData;
+    };
+
+    struct Batch
+    {
+        /** Index of the first record of the batch. */
+        std::size_t nFirstRecord;
+        std::size_t nRecords;
+        std::vector<Column> aColumns;
+    };
+
+    typedef std::function<void(const Batch& aBatch)> BatchHandler;
+
+public:
+    ColumnExtractor(const std::string& strRecordName, const std::size_t& nBatchSize);
+
+public:
+    std::size_t addField(const std::string& strName, const std::string& strPath, const ColumnType& eType);
+    std::size_t run(XMLEventReader& aReader, const BatchHandler& aHandler);
+
+    static void writeCSV(std::ostream& aStream, const Batch& aBatch, const bool& bHeader);
+
+protected:
+    struct Field
+    {
+        /** Element names below the record element. */
+        std::vector<std::string> aPath;
+        /** Empty if the field is the text of the element. */
+        std::string strAttribute;
+        ColumnType eType;
+    };
+
+protected:
+    void HandleStartElement(StartElement& aStartElement, const std::vector<std::string>& aPath);
+    void EndRecord(Batch& aBatch);
+    void ClearBatch(Batch& aBatch);
+    bool IsPathPrefix(const std::vector<std::string>& aPath);
+    static std::string GetName(const QName& aName);
+    static void WriteCSVString(std::ostream& aStream, const char* pData, const std::size_t& nLength);
+
+protected:
+    std::string m_strRecordName;
+    std::size_t m_nBatchSize;
+    std::vector<std::string> m_aNames;
+    std::vector<Field> m_aFields;
+
+    /** Values of the fields for the current record. */
+    std::vector<std::string> m_aValues;
+    std::vector<bool> m_aFound;
+    /** Text fields whose element is open, with the depth of the element. */
+    std::vector<std::pair<std::size_t, std::size_t>> m_aCollecting;
+    /** Parses numbers independent of the global locale. */
+    std::istringstream m_aNumberStream;
+
+};
+
+}
+
+#endif
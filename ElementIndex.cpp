@@ -0,0 +1,421 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/ElementIndex.cpp
+ * @details Index file layout, all numbers unsigned little-endian:
+ *     header of 40 bytes (magic "CRSXIDX1", input size, element count,
+ *     offset of the name table, name count; 8 bytes each), then 32 bytes
+ *     per element in document order of the start tags (begin, end, parent;
+ *     8 bytes each, then name id and depth; 4 bytes each), then the name
+ *     table (4 bytes length + bytes per name, "prefix:localPart" or
+ *     "localPart"). The offsets are those of the stream that was indexed,
+ *     so for other encodings than UTF-8, this is the transcoded stream.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "ElementIndex.h"
+#include "SpanEventReader.h"
+#include "StartElement.h"
+#include <memory>
+#include <stdexcept>
+#include <cstring>
+
+namespace cpprstax
+{
+
+const std::uint64_t ElementIndex::ELEMENT_NONE;
+
+static const char g_aMagic[] = { 'C', 'R', 'S', 'X', 'I', 'D', 'X', '1' };
+static const std::size_t g_nHeaderSize(40);
+static const std::size_t g_nElementSize(32);
+/** Number of elements kept in memory until their end offset is known.
+  * Elements written before get their end offset patched in. */
+static const std::size_t g_nPendingMax(4096);
+
+
+
+ElementIndex::ElementIndex(std::istream& aIndex):
+  m_aIndex(aIndex),
+  m_nInputSize(0),
+  m_nElementCount(0)
+{
+    char aHeader[g_nHeaderSize];
+
+    m_aIndex.clear();
+    m_aIndex.seekg(0);
+    m_aIndex.read(aHeader, g_nHeaderSize);
+
+    if (m_aIndex.gcount() != static_cast<std::streamsize>(g_nHeaderSize))
+    {
+        throw new std::runtime_error("Index incomplete.");
+    }
+
+    if (std::memcmp(aHeader, g_aMagic, sizeof(g_aMagic)) != 0)
+    {
+        throw new std::runtime_error("Not an element index.");
+    }
+
+    m_nInputSize = DecodeNumber(&aHeader[8], 8);
+    m_nElementCount = DecodeNumber(&aHeader[16], 8);
+
+    std::uint64_t nNameTableOffset(DecodeNumber(&aHeader[24], 8));
+    std::uint64_t nNameCount(DecodeNumber(&aHeader[32], 8));
+
+    m_aIndex.seekg(nNameTableOffset);
+
+    for (std::uint64_t i = 0; i < nNameCount; i++)
+    {
+        char aLength[4];
+
+        m_aIndex.read(aLength, 4);
+
+        if (m_aIndex.gcount() != 4)
+        {
+            throw new std::runtime_error("Index incomplete.");
+        }
+
+        std::string strName(DecodeNumber(aLength, 4), '\0');
+
+        if (strName.empty() != true)
+        {
+            m_aIndex.read(&strName[0], strName.length());
+
+            if (m_aIndex.gcount() != static_cast<std::streamsize>(strName.length()))
+            {
+                throw new std::runtime_error("Index incomplete.");
+            }
+        }
+
+        m_aNameIds.insert(std::pair<std::string, std::uint32_t>(strName, m_aNames.size()));
+        m_aNames.push_back(strName);
+    }
+}
+
+/**
+ * @brief Reads aInput from the start and writes the index for it.
+ * @param[out] aIndex Needs to be seekable.
+ * @retval Number of elements.
+ */
+std::uint64_t ElementIndex::build(std::istream& aInput, std::ostream& aIndex)
+{
+    aInput.clear();
+    aInput.seekg(0, std::ios_base::end);
+
+    std::streamoff nInputSize(aInput.tellg());
+
+    if (nInputSize < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    aInput.seekg(0);
+
+    char aHeader[g_nHeaderSize] = { };
+    std::memcpy(aHeader, g_aMagic, sizeof(g_aMagic));
+
+    aIndex.seekp(0);
+    aIndex.write(aHeader, g_nHeaderSize);
+
+    SpanEventReader aReader(aInput, nInputSize);
+    std::vector<std::unique_ptr<XMLEvent>> aEvents;
+    std::streamoff nBegin(0);
+    std::streamoff nEnd(0);
+
+    std::vector<std::uint64_t> aOpenElements;
+    std::map<std::string, std::uint32_t> aNameIds;
+    std::vector<const std::string*> aNames;
+    std::deque<Element> aPending;
+    std::uint64_t nPendingBase(0);
+    std::uint64_t nElementCount(0);
+
+    while (aReader.lexNext(aEvents, nEnd) == true)
+    {
+        for (std::vector<std::unique_ptr<XMLEvent>>::iterator iter = aEvents.begin();
+             iter != aEvents.end();
+             iter++)
+        {
+            if ((*iter)->isStartElement() == true)
+            {
+                const QName& aName((*iter)->asStartElement().getName());
+                std::string strName(aName.getLocalPart());
+
+                if (aName.getPrefix().empty() != true)
+                {
+                    strName = aName.getPrefix() + ":" + strName;
+                }
+
+                std::map<std::string, std::uint32_t>::iterator iterName = aNameIds.find(strName);
+
+                if (iterName == aNameIds.end())
+                {
+                    iterName = aNameIds.insert(std::pair<std::string, std::uint32_t>(strName, aNames.size())).first;
+                    aNames.push_back(&(iterName->first));
+                }
+
+                Element aElement = { nBegin,
+                                     -1,
+                                     aOpenElements.empty() == true ? ELEMENT_NONE : aOpenElements.back(),
+                                     iterName->second,
+                                     static_cast<std::uint32_t>(aOpenElements.size()) };
+
+                aPending.push_back(aElement);
+                aOpenElements.push_back(nElementCount);
+                ++nElementCount;
+
+                if (aPending.size() > g_nPendingMax)
+                {
+                    WriteElement(aIndex, aPending.front());
+                    aPending.pop_front();
+                    ++nPendingBase;
+                }
+            }
+            else if ((*iter)->isEndElement() == true)
+            {
+                if (aOpenElements.empty() == true)
+                {
+                    throw new std::runtime_error("End tag without start tag.");
+                }
+
+                std::uint64_t nElement(aOpenElements.back());
+                aOpenElements.pop_back();
+
+                if (nElement >= nPendingBase)
+                {
+                    aPending[nElement - nPendingBase].nEnd = nEnd;
+                }
+                else
+                {
+                    // Long element, already written.
+                    char aEnd[8];
+                    EncodeNumber(aEnd, nEnd, 8);
+
+                    std::streampos nPosition(aIndex.tellp());
+                    aIndex.seekp(g_nHeaderSize + nElement * g_nElementSize + 8);
+                    aIndex.write(aEnd, 8);
+                    aIndex.seekp(nPosition);
+                }
+            }
+        }
+
+        aEvents.clear();
+        nBegin = nEnd;
+    }
+
+    if (aOpenElements.empty() != true)
+    {
+        throw new std::runtime_error("Element not closed.");
+    }
+
+    while (aPending.empty() != true)
+    {
+        WriteElement(aIndex, aPending.front());
+        aPending.pop_front();
+    }
+
+    std::uint64_t nNameTableOffset(g_nHeaderSize + nElementCount * g_nElementSize);
+
+    for (std::vector<const std::string*>::iterator iter = aNames.begin();
+         iter != aNames.end();
+         iter++)
+    {
+        char aLength[4];
+        EncodeNumber(aLength, (*iter)->length(), 4);
+
+        aIndex.write(aLength, 4);
+        aIndex.write((*iter)->data(), (*iter)->length());
+    }
+
+    EncodeNumber(&aHeader[8], nInputSize, 8);
+    EncodeNumber(&aHeader[16], nElementCount, 8);
+    EncodeNumber(&aHeader[24], nNameTableOffset, 8);
+    EncodeNumber(&aHeader[32], aNames.size(), 8);
+
+    aIndex.seekp(0);
+    aIndex.write(aHeader, g_nHeaderSize);
+    aIndex.flush();
+
+    if (aIndex.bad() == true ||
+        aIndex.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    return nElementCount;
+}
+
+/**
+ * @brief Size of the input the index was built for, to detect an index
+ *     that's out of date.
+ */
+std::streamoff ElementIndex::getInputSize() const
+{
+    return m_nInputSize;
+}
+
+std::uint64_t ElementIndex::getElementCount() const
+{
+    return m_nElementCount;
+}
+
+ElementIndex::Element ElementIndex::getElement(const std::uint64_t& nElement)
+{
+    if (nElement >= m_nElementCount)
+    {
+        throw new std::out_of_range("Element index out of range.");
+    }
+
+    char aData[g_nElementSize];
+
+    m_aIndex.clear();
+    m_aIndex.seekg(g_nHeaderSize + nElement * g_nElementSize);
+    m_aIndex.read(aData, g_nElementSize);
+
+    if (m_aIndex.gcount() != static_cast<std::streamsize>(g_nElementSize))
+    {
+        throw new std::runtime_error("Index incomplete.");
+    }
+
+    Element aElement;
+    DecodeElement(aData, aElement);
+
+    return aElement;
+}
+
+/**
+ * @retval Indices of the elements with that name in document order.
+ */
+std::vector<std::uint64_t> ElementIndex::getElementsByName(const std::string& strName)
+{
+    std::vector<std::uint64_t> aElements;
+    std::uint32_t nName(0);
+
+    if (getNameId(strName, nName) != true)
+    {
+        return aElements;
+    }
+
+    std::vector<char> aBuffer(g_nElementSize * 4096);
+
+    m_aIndex.clear();
+    m_aIndex.seekg(g_nHeaderSize);
+
+    for (std::uint64_t nElement = 0; nElement < m_nElementCount; )
+    {
+        std::uint64_t nCount(m_nElementCount - nElement);
+
+        if (nCount > 4096)
+        {
+            nCount = 4096;
+        }
+
+        m_aIndex.read(aBuffer.data(), nCount * g_nElementSize);
+
+        if (m_aIndex.gcount() != static_cast<std::streamsize>(nCount * g_nElementSize))
+        {
+            throw new std::runtime_error("Index incomplete.");
+        }
+
+        for (std::uint64_t i = 0; i < nCount; i++)
+        {
+            if (DecodeNumber(&aBuffer[i * g_nElementSize + 24], 4) == nName)
+            {
+                aElements.push_back(nElement + i);
+            }
+        }
+
+        nElement += nCount;
+    }
+
+    return aElements;
+}
+
+const std::string& ElementIndex::getName(const std::uint32_t& nName) const
+{
+    if (nName >= m_aNames.size())
+    {
+        throw new std::out_of_range("Name index out of range.");
+    }
+
+    return m_aNames[nName];
+}
+
+/**
+ * @retval Returns false if no element has that name.
+ */
+bool ElementIndex::getNameId(const std::string& strName, std::uint32_t& nName) const
+{
+    std::map<std::string, std::uint32_t>::const_iterator iter = m_aNameIds.find(strName);
+
+    if (iter == m_aNameIds.end())
+    {
+        return false;
+    }
+
+    nName = iter->second;
+    return true;
+}
+
+void ElementIndex::WriteElement(std::ostream& aIndex, const Element& aElement)
+{
+    char aData[g_nElementSize];
+
+    EncodeNumber(&aData[0], aElement.nBegin, 8);
+    EncodeNumber(&aData[8], aElement.nEnd, 8);
+    EncodeNumber(&aData[16], aElement.nParent, 8);
+    EncodeNumber(&aData[24], aElement.nName, 4);
+    EncodeNumber(&aData[28], aElement.nDepth, 4);
+
+    aIndex.write(aData, g_nElementSize);
+
+    if (aIndex.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+}
+
+void ElementIndex::DecodeElement(const char* pData, Element& aElement)
+{
+    aElement.nBegin = DecodeNumber(&pData[0], 8);
+    aElement.nEnd = DecodeNumber(&pData[8], 8);
+    aElement.nParent = DecodeNumber(&pData[16], 8);
+    aElement.nName = DecodeNumber(&pData[24], 4);
+    aElement.nDepth = DecodeNumber(&pData[28], 4);
+}
+
+void ElementIndex::EncodeNumber(char* pData, std::uint64_t nNumber, const std::size_t& nSize)
+{
+    for (std::size_t i = 0; i < nSize; i++)
+    {
+        pData[i] = static_cast<char>(nNumber & 0xFF);
+        nNumber >>= 8;
+    }
+}
+
+std::uint64_t ElementIndex::DecodeNumber(const char* pData, const std::size_t& nSize)
+{
+    std::uint64_t nNumber(0);
+
+    for (std::size_t i = nSize; i > 0; i--)
+    {
+        nNumber = (nNumber << 8) | static_cast<unsigned char>(pData[i - 1]);
+    }
+
+    return nNumber;
+}
+
+}
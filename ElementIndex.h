@@ -0,0 +1,89 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/ElementIndex.h
+ * @brief Sidecar index file with the byte offsets of all elements of a
+ *     document, for positioning a stream at an element without reading
+ *     the input before it.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_ELEMENTINDEX_H
+#define _CPPRSTAX_ELEMENTINDEX_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <cstdint>
+
+namespace cpprstax
+{
+
+class ElementIndex
+{
+public:
+    struct Element
+    {
+        /** Position of the '<' of the start tag. */
+        std::streamoff nBegin;
+        /** Position after the '>' of the end tag. */
+        std::streamoff nEnd;
+        /** Index of the parent element, ELEMENT_NONE for the root. */
+        std::uint64_t nParent;
+        std::uint32_t nName;
+        std::uint32_t nDepth;
+    };
+
+    static const std::uint64_t ELEMENT_NONE = UINT64_MAX;
+
+public:
+    ElementIndex(std::istream& aIndex);
+
+public:
+    static std::uint64_t build(std::istream& aInput, std::ostream& aIndex);
+
+public:
+    std::streamoff getInputSize() const;
+    std::uint64_t getElementCount() const;
+    Element getElement(const std::uint64_t& nElement);
+    std::vector<std::uint64_t> getElementsByName(const std::string& strName);
+
+    const std::string& getName(const std::uint32_t& nName) const;
+    bool getNameId(const std::string& strName, std::uint32_t& nName) const;
+
+protected:
+    static void WriteElement(std::ostream& aIndex, const Element& aElement);
+    static void DecodeElement(const char* pData, Element& aElement);
+    static void EncodeNumber(char* pData, std::uint64_t nNumber, const std::size_t& nSize);
+    static std::uint64_t DecodeNumber(const char* pData, const std::size_t& nSize);
+
+protected:
+    std::istream& m_aIndex;
+    std::streamoff m_nInputSize;
+    std::uint64_t m_nElementCount;
+    std::vector<std::string> m_aNames;
+    std::map<std::string, std::uint32_t> m_aNameIds;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,692 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/EntityTable.cpp
+ * @details The names are kept in two tries, one of them for the reversed
+ *     names, in a single vector of nodes. A lookup steps through the name
+ *     once, without comparing whole keys, and without a temporary string
+ *     if the name is passed as pointer and length. The replacement texts,
+ *     forward and reversed, are kept in one buffer the nodes point into.
+ *
+ *     Snapshot file layout, all numbers unsigned little-endian: header of
+ *     16 bytes (magic "CRSXENT1", node count, text size; 4 bytes each),
+ *     then the nodes with 20 bytes each in the layout of EntityTable::Node,
+ *     then the texts. On a little-endian host, the mapped file is used for
+ *     lookup as it is. Loading only checks that the nodes reachable from
+ *     the roots form two trees, with their indices and text ranges within
+ *     the snapshot, which keeps lookups from running away on a corrupt
+ *     file. The names and texts themselves aren't checked.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "EntityTable.h"
+#include "XMLEventReader.h"
+#include "StartElement.h"
+#include "Characters.h"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cpprstax
+{
+
+const std::uint32_t EntityTable::NONE;
+const std::uint32_t EntityTable::ROOT;
+const std::uint32_t EntityTable::ROOT_REVERSE;
+
+static const char g_aMagic[] = { 'C', 'R', 'S', 'X', 'E', 'N', 'T', '1' };
+static const std::size_t g_nHeaderSize(16);
+static const std::size_t g_nNodeSize(20);
+
+
+
+EntityTable::Snapshot::Snapshot():
+  pData(nullptr),
+  nSize(0),
+  pNodes(nullptr),
+  nNodeCount(0),
+  pTexts(nullptr),
+  nTextSize(0)
+{
+
+}
+
+EntityTable::Snapshot::~Snapshot()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if (pData != nullptr)
+    {
+        munmap(pData, nSize);
+    }
+#endif
+}
+
+
+
+/**
+ * @brief Table with the built-in entities only.
+ */
+EntityTable::EntityTable()
+{
+    Node aRoot = { NONE, NONE, NONE, 0, '\0', { } };
+
+    m_aNodes.push_back(aRoot);
+    m_aNodes.push_back(aRoot);
+
+    const char* aBuiltIn[][2] = { { "amp", "&" },
+                                  { "lt", "<" },
+                                  { "gt", ">" },
+                                  { "apos", "'" },
+                                  { "quot", "\"" } };
+
+    for (std::size_t i = 0; i < sizeof(aBuiltIn) / sizeof(aBuiltIn[0]); i++)
+    {
+        std::string strName(aBuiltIn[i][0]);
+        std::uint32_t nText(AddText(aBuiltIn[i][1]));
+
+        Insert(ROOT, strName, nText, 1);
+        Insert(ROOT_REVERSE, std::string(strName.rbegin(), strName.rend()), nText, 1);
+    }
+}
+
+/**
+ * @brief The table with the built-in entities, which every reader starts
+ *     with. Built once on first use.
+ */
+const std::shared_ptr<const EntityTable>& EntityTable::getDefault()
+{
+    static const std::shared_ptr<const EntityTable> pDefault(new EntityTable());
+    return pDefault;
+}
+
+/**
+ * @brief Loads a table saved with writeSnapshot(). The file is mapped into
+ *     memory where possible and stays mapped as long as the table exists.
+ */
+std::shared_ptr<const EntityTable> EntityTable::loadSnapshot(const std::string& strFilePath)
+{
+    static_assert(sizeof(Node) == g_nNodeSize, "Layout of EntityTable::Node doesn't match the snapshot.");
+
+    std::shared_ptr<EntityTable> pTable(new EntityTable());
+    const std::uint32_t nByteOrder(1);
+
+#if defined(__unix__) || defined(__APPLE__)
+    if (*reinterpret_cast<const char*>(&nByteOrder) == 1)
+    {
+        int nFile(open(strFilePath.c_str(), O_RDONLY));
+
+        if (nFile < 0)
+        {
+            throw new std::runtime_error("Couldn't open entity snapshot.");
+        }
+
+        struct stat aStatus;
+
+        if (fstat(nFile, &aStatus) != 0)
+        {
+            close(nFile);
+            throw new std::runtime_error("Couldn't open entity snapshot.");
+        }
+
+        std::shared_ptr<Snapshot> pSnapshot(new Snapshot());
+        pSnapshot->nSize = aStatus.st_size;
+
+        if (pSnapshot->nSize >= g_nHeaderSize)
+        {
+            int nFlags(MAP_PRIVATE);
+
+#ifdef MAP_POPULATE
+            // All pages get touched by CheckNodes() anyway.
+            nFlags |= MAP_POPULATE;
+#endif
+
+            void* pData(mmap(nullptr, pSnapshot->nSize, PROT_READ, nFlags, nFile, 0));
+
+            if (pData != MAP_FAILED)
+            {
+                pSnapshot->pData = pData;
+            }
+        }
+
+        close(nFile);
+
+        if (pSnapshot->pData != nullptr)
+        {
+            const char* pBytes(static_cast<const char*>(pSnapshot->pData));
+
+            CheckSnapshot(pBytes, pSnapshot->nSize, pSnapshot->nNodeCount, pSnapshot->nTextSize);
+
+            pSnapshot->pNodes = reinterpret_cast<const Node*>(pBytes + g_nHeaderSize);
+            pSnapshot->pTexts = pBytes + g_nHeaderSize + pSnapshot->nNodeCount * g_nNodeSize;
+
+            CheckNodes(pSnapshot->pNodes, pSnapshot->nNodeCount, pSnapshot->nTextSize);
+
+            pTable->m_aNodes.clear();
+            pTable->m_aTexts.clear();
+            pTable->m_pSnapshot = pSnapshot;
+
+            return pTable;
+        }
+    }
+#endif
+
+    // Without mapping or on a big-endian host, the nodes get decoded.
+    std::ifstream aStream(strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open entity snapshot.");
+    }
+
+    std::vector<char> aData((std::istreambuf_iterator<char>(aStream)), std::istreambuf_iterator<char>());
+
+    if (aStream.bad() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    pTable->Decode(aData.data(), aData.size());
+
+    return pTable;
+}
+
+/**
+ * @attention Not to be called any more once the table is shared.
+ */
+int EntityTable::add(const std::string& strName, const std::string& strReplacementText)
+{
+    if (strName == "amp" ||
+        strName == "lt" ||
+        strName == "gt" ||
+        strName == "apos" ||
+        strName == "quot")
+    {
+        throw new std::invalid_argument("Redefinition of built-in entity.");
+    }
+
+    if (strName.empty() == true)
+    {
+        throw new std::invalid_argument("Entity without name.");
+    }
+
+    if (strName.at(0) == '#')
+    {
+        throw new std::invalid_argument("Entity name collides with character references.");
+    }
+
+    Detach();
+
+    // Redefinition leaves the previous replacement text unused in m_aTexts.
+    std::uint32_t nText(AddText(strReplacementText));
+    std::uint32_t nReversedText(AddText(std::string(strReplacementText.rbegin(), strReplacementText.rend())));
+
+    Insert(ROOT, strName, nText, strReplacementText.length());
+    Insert(ROOT_REVERSE, std::string(strName.rbegin(), strName.rend()), nReversedText, strReplacementText.length());
+
+    return 0;
+}
+
+/**
+ * @brief Adds the entities of a catalogue like
+ *     <entities><entity name="nbsp">&#xA0;</entity></entities>, where the
+ *     replacement text is the text content of the entity element. Built-in
+ *     entities may be listed with their built-in replacement text.
+ * @attention Not to be called any more once the table is shared.
+ * @retval Number of entities added.
+ */
+std::size_t EntityTable::addCatalogue(std::istream& aCatalogue)
+{
+    XMLEventReader aReader(aCatalogue);
+    std::size_t nCount(0);
+    std::string strName;
+    std::string strReplacementText;
+    bool bInEntity(false);
+
+    while (aReader.hasNext() == true)
+    {
+        std::unique_ptr<XMLEvent> pEvent(aReader.nextEvent());
+
+        if (pEvent->isStartElement() == true)
+        {
+            StartElement& aStartElement(pEvent->asStartElement());
+
+            if (aStartElement.getName().getLocalPart() != "entity")
+            {
+                continue;
+            }
+
+            if (bInEntity == true)
+            {
+                throw new std::runtime_error("Entity element within entity element in catalogue.");
+            }
+
+            strName.clear();
+            strReplacementText.clear();
+
+            const std::shared_ptr<std::list<std::shared_ptr<Attribute>>> pAttributes(aStartElement.getAttributes());
+
+            for (std::list<std::shared_ptr<Attribute>>::const_iterator iter = pAttributes->begin();
+                 iter != pAttributes->end();
+                 iter++)
+            {
+                if ((*iter)->getName().getPrefix().empty() == true &&
+                    (*iter)->getName().getLocalPart() == "name")
+                {
+                    strName = (*iter)->getValue();
+                }
+            }
+
+            if (strName.empty() == true)
+            {
+                throw new std::runtime_error("Entity without name in catalogue.");
+            }
+
+            bInEntity = true;
+        }
+        else if (pEvent->isCharacters() == true)
+        {
+            if (bInEntity == true)
+            {
+                strReplacementText.append(pEvent->asCharacters().getData());
+            }
+        }
+        else if (pEvent->isEndElement() == true)
+        {
+            if (bInEntity != true ||
+                pEvent->asEndElement().getName().getLocalPart() != "entity")
+            {
+                continue;
+            }
+
+            bInEntity = false;
+
+            std::size_t nTextLength(0);
+            const char* pText(getDefault()->resolve(strName, nTextLength));
+
+            if (pText != nullptr &&
+                strReplacementText.compare(0, std::string::npos, pText, nTextLength) == 0)
+            {
+                continue;
+            }
+
+            add(strName, strReplacementText);
+            ++nCount;
+        }
+    }
+
+    return nCount;
+}
+
+/**
+ * @brief Saves the table for loadSnapshot().
+ */
+void EntityTable::writeSnapshot(std::ostream& aStream) const
+{
+    const Node* pNodes(m_pSnapshot != nullptr ? m_pSnapshot->pNodes : m_aNodes.data());
+    std::uint32_t nNodeCount(m_pSnapshot != nullptr ? m_pSnapshot->nNodeCount : m_aNodes.size());
+    const char* pTexts(m_pSnapshot != nullptr ? m_pSnapshot->pTexts : m_aTexts.data());
+    std::uint32_t nTextSize(m_pSnapshot != nullptr ? m_pSnapshot->nTextSize : m_aTexts.size());
+
+    char aHeader[g_nHeaderSize];
+
+    std::memcpy(aHeader, g_aMagic, sizeof(g_aMagic));
+    EncodeNumber(&aHeader[8], nNodeCount, 4);
+    EncodeNumber(&aHeader[12], nTextSize, 4);
+
+    aStream.write(aHeader, g_nHeaderSize);
+
+    for (std::uint32_t i = 0; i < nNodeCount; i++)
+    {
+        char aNode[g_nNodeSize] = { };
+
+        EncodeNumber(&aNode[0], pNodes[i].nChild, 4);
+        EncodeNumber(&aNode[4], pNodes[i].nSibling, 4);
+        EncodeNumber(&aNode[8], pNodes[i].nText, 4);
+        EncodeNumber(&aNode[12], pNodes[i].nTextLength, 4);
+        aNode[16] = pNodes[i].cByte;
+
+        aStream.write(aNode, g_nNodeSize);
+    }
+
+    aStream.write(pTexts, nTextSize);
+
+    if (aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+}
+
+/**
+ * @param[out] nTextLength Length of the replacement text.
+ * @retval Replacement text, not null-terminated, or nullptr if the entity
+ *     isn't known.
+ */
+const char* EntityTable::resolve(const std::string& strName, std::size_t& nTextLength) const
+{
+    return resolve(strName.data(), strName.length(), nTextLength);
+}
+
+/**
+ * @param[out] nTextLength Length of the replacement text.
+ * @retval Replacement text, not null-terminated, or nullptr if the entity
+ *     isn't known.
+ */
+const char* EntityTable::resolve(const char* pName, const std::size_t& nLength, std::size_t& nTextLength) const
+{
+    const Node* pNodes(m_pSnapshot != nullptr ? m_pSnapshot->pNodes : m_aNodes.data());
+    std::uint32_t nNode(Find(pNodes, ROOT, pName, nLength));
+
+    if (nNode == NONE ||
+        pNodes[nNode].nText == NONE)
+    {
+        return nullptr;
+    }
+
+    nTextLength = pNodes[nNode].nTextLength;
+    return (m_pSnapshot != nullptr ? m_pSnapshot->pTexts : m_aTexts.data()) + pNodes[nNode].nText;
+}
+
+/**
+ * @param[in] strReversedName Entity name as read backwards.
+ * @param[out] nTextLength Length of the replacement text.
+ * @retval Reversed replacement text, or nullptr if the entity isn't known.
+ */
+const char* EntityTable::resolveReverse(const std::string& strReversedName, std::size_t& nTextLength) const
+{
+    return resolveReverse(strReversedName.data(), strReversedName.length(), nTextLength);
+}
+
+/**
+ * @param[in] pReversedName Entity name as read backwards.
+ * @param[out] nTextLength Length of the replacement text.
+ * @retval Reversed replacement text, or nullptr if the entity isn't known.
+ */
+const char* EntityTable::resolveReverse(const char* pReversedName, const std::size_t& nLength, std::size_t& nTextLength) const
+{
+    const Node* pNodes(m_pSnapshot != nullptr ? m_pSnapshot->pNodes : m_aNodes.data());
+    std::uint32_t nNode(Find(pNodes, ROOT_REVERSE, pReversedName, nLength));
+
+    if (nNode == NONE ||
+        pNodes[nNode].nText == NONE)
+    {
+        return nullptr;
+    }
+
+    nTextLength = pNodes[nNode].nTextLength;
+    return (m_pSnapshot != nullptr ? m_pSnapshot->pTexts : m_aTexts.data()) + pNodes[nNode].nText;
+}
+
+/**
+ * @retval All entities by name, including the built-in ones.
+ */
+std::map<std::string, std::string> EntityTable::getEntities() const
+{
+    const Node* pNodes(m_pSnapshot != nullptr ? m_pSnapshot->pNodes : m_aNodes.data());
+    const char* pTexts(m_pSnapshot != nullptr ? m_pSnapshot->pTexts : m_aTexts.data());
+
+    std::map<std::string, std::string> aEntities;
+    std::string strName;
+    // Nodes still to visit, with the length of the name of their parent.
+    std::vector<std::pair<std::uint32_t, std::size_t>> aNodes;
+
+    aNodes.push_back(std::pair<std::uint32_t, std::size_t>(ROOT, 0));
+
+    while (aNodes.empty() != true)
+    {
+        std::uint32_t nNode(aNodes.back().first);
+
+        strName.resize(aNodes.back().second);
+        aNodes.pop_back();
+
+        if (nNode != ROOT)
+        {
+            strName.push_back(pNodes[nNode].cByte);
+        }
+
+        if (pNodes[nNode].nText != NONE)
+        {
+            aEntities[strName] = std::string(pTexts + pNodes[nNode].nText, pNodes[nNode].nTextLength);
+        }
+
+        for (std::uint32_t nChild = pNodes[nNode].nChild; nChild != NONE; nChild = pNodes[nChild].nSibling)
+        {
+            aNodes.push_back(std::pair<std::uint32_t, std::size_t>(nChild, strName.length()));
+        }
+    }
+
+    return aEntities;
+}
+
+void EntityTable::Insert(std::uint32_t nNode, const std::string& strKey, const std::uint32_t& nText, const std::uint32_t& nTextLength)
+{
+    for (std::string::const_iterator iter = strKey.begin();
+         iter != strKey.end();
+         iter++)
+    {
+        std::uint32_t nChild(m_aNodes[nNode].nChild);
+
+        while (nChild != NONE &&
+               m_aNodes[nChild].cByte != *iter)
+        {
+            nChild = m_aNodes[nChild].nSibling;
+        }
+
+        if (nChild == NONE)
+        {
+            Node aNode = { NONE, m_aNodes[nNode].nChild, NONE, 0, *iter, { } };
+
+            nChild = m_aNodes.size();
+            m_aNodes.push_back(aNode);
+            m_aNodes[nNode].nChild = nChild;
+        }
+
+        nNode = nChild;
+    }
+
+    m_aNodes[nNode].nText = nText;
+    m_aNodes[nNode].nTextLength = nTextLength;
+}
+
+/**
+ * @retval Node at which pKey ends, or NONE.
+ */
+std::uint32_t EntityTable::Find(const Node* pNodes, std::uint32_t nNode, const char* pKey, const std::size_t& nLength)
+{
+    for (std::size_t i = 0; i < nLength; i++)
+    {
+        nNode = pNodes[nNode].nChild;
+
+        while (nNode != NONE &&
+               pNodes[nNode].cByte != pKey[i])
+        {
+            nNode = pNodes[nNode].nSibling;
+        }
+
+        if (nNode == NONE)
+        {
+            return NONE;
+        }
+    }
+
+    return nNode;
+}
+
+/**
+ * @retval Offset of the text in m_aTexts.
+ */
+std::uint32_t EntityTable::AddText(const std::string& strText)
+{
+    if (strText.length() > UINT32_MAX - 1 - m_aTexts.size())
+    {
+        throw new std::length_error("Entity replacement texts too long.");
+    }
+
+    std::uint32_t nText(m_aTexts.size());
+
+    m_aTexts.insert(m_aTexts.end(), strText.begin(), strText.end());
+
+    return nText;
+}
+
+/**
+ * @brief Copies the nodes and texts of a mapped snapshot, so they can be
+ *     added to.
+ */
+void EntityTable::Detach()
+{
+    if (m_pSnapshot == nullptr)
+    {
+        return;
+    }
+
+    m_aNodes.assign(m_pSnapshot->pNodes, m_pSnapshot->pNodes + m_pSnapshot->nNodeCount);
+    m_aTexts.assign(m_pSnapshot->pTexts, m_pSnapshot->pTexts + m_pSnapshot->nTextSize);
+    m_pSnapshot = nullptr;
+}
+
+/**
+ * @brief Reads the nodes and texts of a snapshot into m_aNodes and m_aTexts.
+ */
+void EntityTable::Decode(const char* pData, const std::size_t& nSize)
+{
+    std::uint32_t nNodeCount(0);
+    std::uint32_t nTextSize(0);
+
+    CheckSnapshot(pData, nSize, nNodeCount, nTextSize);
+
+    m_aNodes.resize(nNodeCount);
+
+    for (std::uint32_t i = 0; i < nNodeCount; i++)
+    {
+        const char* pNode(pData + g_nHeaderSize + i * g_nNodeSize);
+
+        m_aNodes[i].nChild = DecodeNumber(&pNode[0], 4);
+        m_aNodes[i].nSibling = DecodeNumber(&pNode[4], 4);
+        m_aNodes[i].nText = DecodeNumber(&pNode[8], 4);
+        m_aNodes[i].nTextLength = DecodeNumber(&pNode[12], 4);
+        m_aNodes[i].cByte = pNode[16];
+    }
+
+    const char* pTexts(pData + g_nHeaderSize + nNodeCount * g_nNodeSize);
+
+    m_aTexts.assign(pTexts, pTexts + nTextSize);
+    m_pSnapshot = nullptr;
+
+    CheckNodes(m_aNodes.data(), nNodeCount, nTextSize);
+}
+
+/**
+ * @brief Checks the header against the size of the snapshot.
+ */
+void EntityTable::CheckSnapshot(const char* pData, const std::size_t& nSize, std::uint32_t& nNodeCount, std::uint32_t& nTextSize)
+{
+    if (nSize < g_nHeaderSize)
+    {
+        throw new std::runtime_error("Entity snapshot incomplete.");
+    }
+
+    if (std::memcmp(pData, g_aMagic, sizeof(g_aMagic)) != 0)
+    {
+        throw new std::runtime_error("Not an entity snapshot.");
+    }
+
+    nNodeCount = DecodeNumber(&pData[8], 4);
+    nTextSize = DecodeNumber(&pData[12], 4);
+
+    if (nNodeCount < 2)
+    {
+        throw new std::runtime_error("Entity snapshot without roots.");
+    }
+
+    if (static_cast<std::uint64_t>(nSize) != g_nHeaderSize + static_cast<std::uint64_t>(nNodeCount) * g_nNodeSize + nTextSize)
+    {
+        throw new std::runtime_error("Entity snapshot incomplete.");
+    }
+}
+
+/**
+ * @brief Makes sure that lookups and getEntities() stay within the snapshot
+ *     and terminate. As no node may be the child or sibling of more than one
+ *     node and the roots of none, what's reachable from ROOT and ROOT_REVERSE
+ *     are two trees.
+ */
+void EntityTable::CheckNodes(const Node* pNodes, const std::uint32_t& nNodeCount, const std::uint32_t& nTextSize)
+{
+    std::vector<std::uint8_t> aReferenced(nNodeCount, 0);
+
+    aReferenced[ROOT] = 1;
+    aReferenced[ROOT_REVERSE] = 1;
+
+    for (std::uint32_t i = 0; i < nNodeCount; i++)
+    {
+        const std::uint32_t aNext[2] = { pNodes[i].nChild, pNodes[i].nSibling };
+
+        for (std::size_t j = 0; j < 2; j++)
+        {
+            if (aNext[j] == NONE)
+            {
+                continue;
+            }
+
+            if (aNext[j] >= nNodeCount ||
+                aReferenced[aNext[j]] != 0)
+            {
+                throw new std::runtime_error("Entity snapshot corrupt.");
+            }
+
+            aReferenced[aNext[j]] = 1;
+        }
+
+        if (pNodes[i].nText != NONE &&
+            (pNodes[i].nText > nTextSize || pNodes[i].nTextLength > nTextSize - pNodes[i].nText))
+        {
+            throw new std::runtime_error("Entity snapshot corrupt.");
+        }
+    }
+}
+
+void EntityTable::EncodeNumber(char* pData, std::uint64_t nNumber, const std::size_t& nSize)
+{
+    for (std::size_t i = 0; i < nSize; i++)
+    {
+        pData[i] = static_cast<char>(nNumber & 0xFF);
+        nNumber >>= 8;
+    }
+}
+
+std::uint64_t EntityTable::DecodeNumber(const char* pData, const std::size_t& nSize)
+{
+    std::uint64_t nNumber(0);
+
+    for (std::size_t i = nSize; i > 0; i--)
+    {
+        nNumber = (nNumber << 8) | static_cast<unsigned char>(pData[i - 1]);
+    }
+
+    return nNumber;
+}
+
+}
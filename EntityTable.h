@@ -0,0 +1,123 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/EntityTable.h
+ * @brief Entity replacement texts for both reading directions. Once built,
+ *     a table is meant to be shared as std::shared_ptr<const EntityTable>
+ *     by any number of readers, also across threads. Larger tables can be
+ *     loaded from an XML catalogue and saved as a snapshot, which is used
+ *     for lookup as it is, without being parsed again.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_ENTITYTABLE_H
+#define _CPPRSTAX_ENTITYTABLE_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace cpprstax
+{
+
+class EntityTable
+{
+public:
+    EntityTable();
+
+public:
+    static const std::shared_ptr<const EntityTable>& getDefault();
+    static std::shared_ptr<const EntityTable> loadSnapshot(const std::string& strFilePath);
+
+public:
+    int add(const std::string& strName, const std::string& strReplacementText);
+    std::size_t addCatalogue(std::istream& aCatalogue);
+    void writeSnapshot(std::ostream& aStream) const;
+
+    const char* resolve(const std::string& strName, std::size_t& nTextLength) const;
+    const char* resolve(const char* pName, const std::size_t& nLength, std::size_t& nTextLength) const;
+    const char* resolveReverse(const std::string& strReversedName, std::size_t& nTextLength) const;
+    const char* resolveReverse(const char* pReversedName, const std::size_t& nLength, std::size_t& nTextLength) const;
+    std::map<std::string, std::string> getEntities() const;
+
+protected:
+    /**
+     * @brief Trie node, with its children as a linked list of siblings.
+     *     Same layout in memory and in a snapshot, 20 bytes.
+     */
+    struct Node
+    {
+        std::uint32_t nChild;
+        std::uint32_t nSibling;
+        /** Offset of the replacement text of the entity whose name ends
+          * here, or NONE. */
+        std::uint32_t nText;
+        std::uint32_t nTextLength;
+        char cByte;
+        char aReserved[3];
+    };
+
+    /**
+     * @brief Mapped snapshot file, unmapped with the last table using it.
+     */
+    struct Snapshot
+    {
+        Snapshot();
+        ~Snapshot();
+
+        void* pData;
+        std::size_t nSize;
+        const Node* pNodes;
+        std::uint32_t nNodeCount;
+        const char* pTexts;
+        std::uint32_t nTextSize;
+    };
+
+    static const std::uint32_t NONE = UINT32_MAX;
+    static const std::uint32_t ROOT = 0;
+    static const std::uint32_t ROOT_REVERSE = 1;
+
+protected:
+    void Insert(std::uint32_t nNode, const std::string& strKey, const std::uint32_t& nText, const std::uint32_t& nTextLength);
+    static std::uint32_t Find(const Node* pNodes, std::uint32_t nNode, const char* pKey, const std::size_t& nLength);
+    std::uint32_t AddText(const std::string& strText);
+    void Detach();
+    void Decode(const char* pData, const std::size_t& nSize);
+    static void CheckSnapshot(const char* pData, const std::size_t& nSize, std::uint32_t& nNodeCount, std::uint32_t& nTextSize);
+    static void CheckNodes(const Node* pNodes, const std::uint32_t& nNodeCount, const std::uint32_t& nTextSize);
+    static void EncodeNumber(char* pData, std::uint64_t nNumber, const std::size_t& nSize);
+    static std::uint64_t DecodeNumber(const char* pData, const std::size_t& nSize);
+
+protected:
+    /** Tries of the names and the reversed names, starting at ROOT and
+      * ROOT_REVERSE. Nodes of the reversed names point to the reversed
+      * replacement texts. Unused if m_pSnapshot is set. */
+    std::vector<Node> m_aNodes;
+    std::vector<char> m_aTexts;
+    /** Set if the nodes and texts are the ones of a mapped snapshot. */
+    std::shared_ptr<const Snapshot> m_pSnapshot;
+
+};
+
+}
+
+#endif
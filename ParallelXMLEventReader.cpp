@@ -0,0 +1,358 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/ParallelXMLEventReader.cpp
+ * @details The input is processed in rounds of one chunk per thread. The
+ *     first chunk of a round starts where the previous round ended, all others
+ *     start at a tag boundary guessed by XMLEventReader::seek(). Every chunk
+ *     is lexed by its own XMLEventReader up to the first token boundary at or
+ *     after the start of the next chunk. When merging, a chunk is only taken over if it
+ *     started exactly where the lexing of its predecessor ended, which can't
+ *     be the case if the guess landed inside a comment, processing instruction
+ *     or the like. Otherwise, the chunk is lexed again sequentially from the
+ *     validated position. While the events of a round are consumed, the next
+ *     round is already lexed.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "ParallelXMLEventReader.h"
+#include "XMLEventReader.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace cpprstax
+{
+
+/**
+ * @brief Gives access to the lexer of XMLEventReader token by token, so
+ *     lexing can stop at a token boundary without losing queued events.
+ */
+class ChunkEventReader : public XMLEventReader
+{
+public:
+    ChunkEventReader(std::istream& aStream, const std::streamoff& nFileSize);
+
+public:
+    std::streamoff Lex(const std::streamoff& nLimit, std::vector<std::unique_ptr<XMLEvent>>& aEvents);
+
+protected:
+    std::streamoff m_nFileSize;
+
+};
+
+ChunkEventReader::ChunkEventReader(std::istream& aStream, const std::streamoff& nFileSize):
+  XMLEventReader(aStream),
+  m_nFileSize(nFileSize)
+{
+
+}
+
+/**
+ * @retval Position where lexing stopped, which is the end of the last token.
+ */
+std::streamoff ChunkEventReader::Lex(const std::streamoff& nLimit, std::vector<std::unique_ptr<XMLEvent>>& aEvents)
+{
+    std::streamoff nPosition(m_aStream.tellg());
+
+    while (nPosition < nLimit)
+    {
+        // Token by token, as hasNext() would go on past skipped whitespace.
+        m_bHasNextCalled = true;
+
+        if (HandleToken() != true &&
+            m_bHasNextCalled == true)
+        {
+            return m_nFileSize;
+        }
+
+        while (m_aEvents.empty() != true)
+        {
+            aEvents.push_back(std::move(m_aEvents.front()));
+            m_aEvents.pop();
+        }
+
+        if (m_aStream.eof() == true)
+        {
+            return m_nFileSize;
+        }
+
+        nPosition = m_aStream.tellg();
+    }
+
+    return nPosition;
+}
+
+
+
+ParallelXMLEventReader::ParallelXMLEventReader(const std::string& strFilePath, const unsigned int& nThreadCount):
+  m_strFilePath(strFilePath),
+  m_nThreadCount(nThreadCount),
+  m_nChunkSize(1048576),
+  m_nFileSize(0),
+  m_nPosition(0),
+  m_pEntityTable(new EntityTable()),
+  m_bSuppressWhitespace(false),
+  m_bRoundRunning(false)
+{
+    if (m_nThreadCount <= 0)
+    {
+        throw new std::invalid_argument("No threads to read with.");
+    }
+
+    std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    aStream.seekg(0, std::ios_base::end);
+    m_nFileSize = aStream.tellg();
+
+    if (m_nFileSize < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+}
+
+ParallelXMLEventReader::~ParallelXMLEventReader()
+{
+    for (std::vector<std::thread>::iterator iter = m_aThreads.begin();
+         iter != m_aThreads.end();
+         iter++)
+    {
+        if (iter->joinable() == true)
+        {
+            iter->join();
+        }
+    }
+}
+
+bool ParallelXMLEventReader::hasNext()
+{
+    while (m_aEvents.empty() == true)
+    {
+        if (m_bRoundRunning != true)
+        {
+            if (m_nPosition >= m_nFileSize)
+            {
+                return false;
+            }
+
+            StartRound();
+        }
+
+        FinishRound();
+
+        if (m_nPosition < m_nFileSize)
+        {
+            StartRound();
+        }
+    }
+
+    return true;
+}
+
+std::unique_ptr<XMLEvent> ParallelXMLEventReader::nextEvent()
+{
+    if (hasNext() != true)
+    {
+        throw new std::logic_error("Attempted ParallelXMLEventReader::nextEvent() while there isn't one instead of checking ParallelXMLEventReader::hasNext() first.");
+    }
+
+    std::unique_ptr<XMLEvent> pEvent(std::move(m_aEvents.front()));
+    m_aEvents.pop_front();
+
+    return pEvent;
+}
+
+int ParallelXMLEventReader::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+{
+    if (m_bRoundRunning == true)
+    {
+        throw new std::logic_error("Entities need to be added before reading.");
+    }
+
+    return m_pEntityTable->add(strName, strReplacementText);
+}
+
+void ParallelXMLEventReader::setSuppressWhitespace(const bool& bSuppress)
+{
+    m_bSuppressWhitespace = bSuppress;
+}
+
+void ParallelXMLEventReader::setChunkSize(const std::streamoff& nChunkSize)
+{
+    if (nChunkSize <= 0)
+    {
+        throw new std::invalid_argument("Chunk size needs to be positive.");
+    }
+
+    m_nChunkSize = nChunkSize;
+}
+
+void ParallelXMLEventReader::StartRound()
+{
+    std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    XMLEventReader aReader(aStream);
+
+    m_aChunks.clear();
+    m_aChunks.resize(m_nThreadCount);
+
+    std::streamoff nBegin(m_nPosition);
+
+    for (unsigned int i = 0; i < m_nThreadCount; i++)
+    {
+        std::streamoff nLimit(m_nPosition + m_nChunkSize * (i + 1));
+
+        if (nLimit >= m_nFileSize)
+        {
+            nLimit = m_nFileSize;
+        }
+        else
+        {
+            nLimit = std::max(aReader.seek(nLimit), nBegin);
+        }
+
+        m_aChunks.at(i).nBegin = nBegin;
+        m_aChunks.at(i).nLimit = nLimit;
+        m_aChunks.at(i).nEnd = nBegin;
+        m_aChunks.at(i).bFailed = false;
+
+        nBegin = nLimit;
+    }
+
+    m_aThreads.clear();
+
+    for (unsigned int i = 0; i < m_nThreadCount; i++)
+    {
+        if (m_aChunks.at(i).nBegin < m_aChunks.at(i).nLimit)
+        {
+            m_aThreads.push_back(std::thread(&ParallelXMLEventReader::LexChunk, this, std::ref(m_aChunks.at(i))));
+        }
+    }
+
+    m_bRoundRunning = true;
+}
+
+void ParallelXMLEventReader::FinishRound()
+{
+    for (std::vector<std::thread>::iterator iter = m_aThreads.begin();
+         iter != m_aThreads.end();
+         iter++)
+    {
+        iter->join();
+    }
+
+    m_aThreads.clear();
+    m_bRoundRunning = false;
+
+    for (std::vector<Chunk>::iterator iter = m_aChunks.begin();
+         iter != m_aChunks.end();
+         iter++)
+    {
+        if (m_nPosition >= iter->nLimit)
+        {
+            // The previous chunk already lexed beyond this one.
+            continue;
+        }
+
+        if (iter->bFailed != true &&
+            iter->nBegin == m_nPosition)
+        {
+            for (std::vector<std::unique_ptr<XMLEvent>>::iterator iterEvent = iter->aEvents.begin();
+                 iterEvent != iter->aEvents.end();
+                 iterEvent++)
+            {
+                m_aEvents.push_back(std::move(*iterEvent));
+            }
+
+            m_nPosition = iter->nEnd;
+        }
+        else
+        {
+            // Misspeculation, so this chunk needs to be lexed again from
+            // the validated position. Errors are real now and not caught.
+            std::vector<std::unique_ptr<XMLEvent>> aEvents;
+
+            m_nPosition = Lex(m_nPosition, iter->nLimit, aEvents);
+
+            for (std::vector<std::unique_ptr<XMLEvent>>::iterator iterEvent = aEvents.begin();
+                 iterEvent != aEvents.end();
+                 iterEvent++)
+            {
+                m_aEvents.push_back(std::move(*iterEvent));
+            }
+        }
+    }
+
+    m_aChunks.clear();
+}
+
+/**
+ * @brief Thread function. A speculative chunk may not start at a real tag
+ *     boundary, so errors only mark the chunk as failed.
+ */
+void ParallelXMLEventReader::LexChunk(Chunk& aChunk)
+{
+    try
+    {
+        aChunk.nEnd = Lex(aChunk.nBegin, aChunk.nLimit, aChunk.aEvents);
+    }
+    catch (std::exception* pException)
+    {
+        delete pException;
+
+        aChunk.aEvents.clear();
+        aChunk.bFailed = true;
+    }
+}
+
+std::streamoff ParallelXMLEventReader::Lex(const std::streamoff& nBegin, const std::streamoff& nLimit, std::vector<std::unique_ptr<XMLEvent>>& aEvents)
+{
+    std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    aStream.seekg(nBegin);
+
+    if (aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    ChunkEventReader aReader(aStream, m_nFileSize);
+
+    aReader.setSuppressWhitespace(m_bSuppressWhitespace);
+
+    aReader.setEntityTable(m_pEntityTable);
+
+    return aReader.Lex(nLimit, aEvents);
+}
+
+}
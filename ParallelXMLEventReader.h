@@ -0,0 +1,92 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/ParallelXMLEventReader.h
+ * @brief Forward reading of a single large file, with chunks of it lexed
+ *     by several threads.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_PARALLELXMLEVENTREADER_H
+#define _CPPRSTAX_PARALLELXMLEVENTREADER_H
+
+#include "XMLEvent.h"
+#include "EntityTable.h"
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+
+namespace cpprstax
+{
+
+class ParallelXMLEventReader
+{
+public:
+    ParallelXMLEventReader(const std::string& strFilePath, const unsigned int& nThreadCount);
+    ~ParallelXMLEventReader();
+
+    bool hasNext();
+    std::unique_ptr<XMLEvent> nextEvent();
+
+public:
+    int addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText);
+    void setSuppressWhitespace(const bool& bSuppress);
+    void setChunkSize(const std::streamoff& nChunkSize);
+
+protected:
+    struct Chunk
+    {
+        /** Speculative start, a tag boundary only if it matches where the
+          * lexing of the previous chunk ended. */
+        std::streamoff nBegin;
+        /** Lexing stops at the first token boundary at or after this. */
+        std::streamoff nLimit;
+        /** Where lexing actually stopped. */
+        std::streamoff nEnd;
+        bool bFailed;
+        std::vector<std::unique_ptr<XMLEvent>> aEvents;
+    };
+
+protected:
+    void StartRound();
+    void FinishRound();
+    void LexChunk(Chunk& aChunk);
+    std::streamoff Lex(const std::streamoff& nBegin, const std::streamoff& nLimit, std::vector<std::unique_ptr<XMLEvent>>& aEvents);
+
+protected:
+    std::string m_strFilePath;
+    unsigned int m_nThreadCount;
+    std::streamoff m_nChunkSize;
+    std::streamoff m_nFileSize;
+    /** End of the input that was lexed and validated so far. */
+    std::streamoff m_nPosition;
+    std::shared_ptr<EntityTable> m_pEntityTable;
+    bool m_bSuppressWhitespace;
+    std::vector<Chunk> m_aChunks;
+    std::vector<std::thread> m_aThreads;
+    bool m_bRoundRunning;
+    std::deque<std::unique_ptr<XMLEvent>> m_aEvents;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/PipelinedXMLEventReader.cpp
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "PipelinedXMLEventReader.h"
+#include <stdexcept>
+#include <chrono>
+
+namespace cpprstax
+{
+
+PipelinedXMLEventReader::PipelinedXMLEventReader(std::unique_ptr<XMLEventReader> pReader, const std::size_t& nCapacity, const std::size_t& nBatchSize):
+  m_pReader(std::move(pReader)),
+  m_nBatchSize(nBatchSize),
+  m_aRing(nCapacity),
+  m_bStarted(false),
+  m_nHead(0),
+  m_nTail(0),
+  m_bFinished(false),
+  m_bStop(false),
+  m_pException(nullptr),
+  m_nBatchPosition(0)
+{
+    if (m_pReader == nullptr)
+    {
+        throw new std::invalid_argument("Nullptr passed.");
+    }
+
+    if (nCapacity <= 0 ||
+        nBatchSize <= 0)
+    {
+        throw new std::invalid_argument("Ring buffer without capacity.");
+    }
+}
+
+PipelinedXMLEventReader::~PipelinedXMLEventReader()
+{
+    m_bStop.store(true, std::memory_order_relaxed);
+
+    if (m_aThread.joinable() == true)
+    {
+        m_aThread.join();
+    }
+
+    if (m_pException != nullptr)
+    {
+        delete m_pException;
+    }
+}
+
+bool PipelinedXMLEventReader::hasNext()
+{
+    if (m_nBatchPosition < m_aBatch.size())
+    {
+        return true;
+    }
+
+    if (m_bStarted != true)
+    {
+        m_aThread = std::thread(&PipelinedXMLEventReader::Produce, this);
+        m_bStarted = true;
+    }
+
+    std::size_t nHead(m_nHead.load(std::memory_order_relaxed));
+
+    for (unsigned int nAttempt = 0; true; nAttempt++)
+    {
+        if (m_nTail.load(std::memory_order_acquire) != nHead)
+        {
+            break;
+        }
+
+        if (m_bFinished.load(std::memory_order_acquire) == true)
+        {
+            // The last batch might have been published in the meantime.
+            if (m_nTail.load(std::memory_order_acquire) != nHead)
+            {
+                break;
+            }
+
+            if (m_pException != nullptr)
+            {
+                std::exception* pException(m_pException);
+                m_pException = nullptr;
+                throw pException;
+            }
+
+            return false;
+        }
+
+        Backoff(nAttempt);
+    }
+
+    m_aBatch.swap(m_aRing[nHead % m_aRing.size()]);
+    m_aRing[nHead % m_aRing.size()].clear();
+    m_nBatchPosition = 0;
+
+    m_nHead.store(nHead + 1, std::memory_order_release);
+
+    return true;
+}
+
+std::unique_ptr<XMLEvent> PipelinedXMLEventReader::nextEvent()
+{
+    if (hasNext() != true)
+    {
+        throw new std::logic_error("Attempted PipelinedXMLEventReader::nextEvent() while there isn't one instead of checking PipelinedXMLEventReader::hasNext() first.");
+    }
+
+    return std::move(m_aBatch[m_nBatchPosition++]);
+}
+
+std::size_t PipelinedXMLEventReader::nextEvents(std::unique_ptr<XMLEvent>* pEvents, const std::size_t& nMax)
+{
+    std::size_t nCount(0);
+
+    while (nCount < nMax &&
+           hasNext() == true)
+    {
+        while (nCount < nMax &&
+               m_nBatchPosition < m_aBatch.size())
+        {
+            pEvents[nCount++] = std::move(m_aBatch[m_nBatchPosition++]);
+        }
+    }
+
+    return nCount;
+}
+
+/**
+ * @brief Thread function.
+ */
+void PipelinedXMLEventReader::Produce()
+{
+    try
+    {
+        std::vector<std::unique_ptr<XMLEvent>> aBatch;
+        aBatch.reserve(m_nBatchSize);
+
+        while (m_pReader->hasNext() == true)
+        {
+            aBatch.push_back(m_pReader->nextEvent());
+
+            if (aBatch.size() >= m_nBatchSize)
+            {
+                Publish(aBatch);
+
+                if (m_bStop.load(std::memory_order_relaxed) == true)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (aBatch.empty() != true)
+        {
+            Publish(aBatch);
+        }
+    }
+    catch (std::exception* pException)
+    {
+        m_pException = pException;
+    }
+
+    m_bFinished.store(true, std::memory_order_release);
+}
+
+void PipelinedXMLEventReader::Publish(std::vector<std::unique_ptr<XMLEvent>>& aBatch)
+{
+    std::size_t nTail(m_nTail.load(std::memory_order_relaxed));
+
+    for (unsigned int nAttempt = 0; true; nAttempt++)
+    {
+        if (nTail - m_nHead.load(std::memory_order_acquire) < m_aRing.size())
+        {
+            break;
+        }
+
+        if (m_bStop.load(std::memory_order_relaxed) == true)
+        {
+            aBatch.clear();
+            return;
+        }
+
+        Backoff(nAttempt);
+    }
+
+    // The slot was cleared by the consumer, so the swap leaves an empty batch.
+    m_aRing[nTail % m_aRing.size()].swap(aBatch);
+    aBatch.reserve(m_nBatchSize);
+
+    m_nTail.store(nTail + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Waits for the other side, first yielding the core, then sleeping,
+ *     so a ring that stays full or empty doesn't keep a core busy.
+ */
+void PipelinedXMLEventReader::Backoff(const unsigned int& nAttempt)
+{
+    if (nAttempt < 64)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+}
@@ -0,0 +1,84 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/PipelinedXMLEventReader.h
+ * @brief Forward reading with the lexing done by a separate thread, which
+ *     passes batches of events through a single-producer/single-consumer
+ *     ring buffer.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_PIPELINEDXMLEVENTREADER_H
+#define _CPPRSTAX_PIPELINEDXMLEVENTREADER_H
+
+#include "XMLEventReader.h"
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+namespace cpprstax
+{
+
+class PipelinedXMLEventReader
+{
+public:
+    /**
+     * @param[in] pReader Configured reader, which is used by the lexing
+     *     thread from the first call of hasNext() on.
+     * @param[in] nCapacity Number of batches the ring buffer can hold
+     *     before the lexing thread waits for the consumer.
+     * @param[in] nBatchSize Number of events per batch.
+     */
+    PipelinedXMLEventReader(std::unique_ptr<XMLEventReader> pReader, const std::size_t& nCapacity, const std::size_t& nBatchSize);
+    ~PipelinedXMLEventReader();
+
+    bool hasNext();
+    std::unique_ptr<XMLEvent> nextEvent();
+    std::size_t nextEvents(std::unique_ptr<XMLEvent>* pEvents, const std::size_t& nMax);
+
+protected:
+    void Produce();
+    void Publish(std::vector<std::unique_ptr<XMLEvent>>& aBatch);
+    void Backoff(const unsigned int& nAttempt);
+
+protected:
+    std::unique_ptr<XMLEventReader> m_pReader;
+    std::size_t m_nBatchSize;
+    std::vector<std::vector<std::unique_ptr<XMLEvent>>> m_aRing;
+    std::thread m_aThread;
+    bool m_bStarted;
+
+    /** Count of batches taken, only written by the consumer. */
+    alignas(64) std::atomic<std::size_t> m_nHead;
+    /** Count of batches published, only written by the producer. */
+    alignas(64) std::atomic<std::size_t> m_nTail;
+    alignas(64) std::atomic<bool> m_bFinished;
+    std::atomic<bool> m_bStop;
+    /** Set by the producer before m_bFinished. */
+    std::exception* m_pException;
+
+    // Consumer side.
+    std::vector<std::unique_ptr<XMLEvent>> m_aBatch;
+    std::size_t m_nBatchPosition;
+
+};
+
+}
+
+#endif
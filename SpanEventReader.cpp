@@ -0,0 +1,102 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/SpanEventReader.cpp
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "SpanEventReader.h"
+#include "StartElement.h"
+
+namespace cpprstax
+{
+
+SpanEventReader::SpanEventReader(std::istream& aStream, const std::streamoff& nFileSize):
+  XMLEventReader(aStream),
+  m_nFileSize(nFileSize)
+{
+
+}
+
+/**
+ * @brief Lexes the next token.
+ * @param[out] nEnd Input position after the token.
+ * @retval Returns false at the end of the input.
+ */
+bool SpanEventReader::lexNext(std::vector<std::unique_ptr<XMLEvent>>& aEvents, std::streamoff& nEnd)
+{
+    m_bHasNextCalled = false;
+
+    if (hasNext() != true)
+    {
+        nEnd = m_nFileSize;
+        return false;
+    }
+
+    while (m_aEvents.empty() != true)
+    {
+        aEvents.push_back(std::move(m_aEvents.front()));
+        m_aEvents.pop();
+    }
+
+    if (m_aStream.eof() == true)
+    {
+        nEnd = m_nFileSize;
+    }
+    else
+    {
+        nEnd = m_aStream.tellg();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Lexes the previous token.
+ * @param[out] nBegin Input position of the start of the token.
+ * @retval Returns false at the start of the input.
+ * @details Attributes are lexed in reverse order, so they're put back into
+ *     document order here.
+ */
+bool SpanEventReader::lexPrevious(std::vector<std::unique_ptr<XMLEvent>>& aEvents, std::streamoff& nBegin)
+{
+    m_bHasPreviousCalled = false;
+
+    if (hasPrevious() != true)
+    {
+        nBegin = 0;
+        return false;
+    }
+
+    while (m_aEvents.empty() != true)
+    {
+        if (m_aEvents.front()->isStartElement() == true)
+        {
+            m_aEvents.front()->asStartElement().getAttributes()->reverse();
+        }
+
+        aEvents.push_back(std::move(m_aEvents.front()));
+        m_aEvents.pop();
+    }
+
+    nBegin = m_aStream.tellg();
+
+    return true;
+}
+
+}
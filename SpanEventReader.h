@@ -0,0 +1,52 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/SpanEventReader.h
+ * @brief XMLEventReader that reports the input position at the boundaries
+ *     of every token it lexes.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_SPANEVENTREADER_H
+#define _CPPRSTAX_SPANEVENTREADER_H
+
+#include "XMLEventReader.h"
+#include <istream>
+#include <memory>
+#include <vector>
+
+namespace cpprstax
+{
+
+class SpanEventReader : public XMLEventReader
+{
+public:
+    SpanEventReader(std::istream& aStream, const std::streamoff& nFileSize);
+
+public:
+    bool lexNext(std::vector<std::unique_ptr<XMLEvent>>& aEvents, std::streamoff& nEnd);
+    bool lexPrevious(std::vector<std::unique_ptr<XMLEvent>>& aEvents, std::streamoff& nBegin);
+
+protected:
+    std::streamoff m_nFileSize;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/TranscodingInputStream.cpp
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "TranscodingInputStream.h"
+
+namespace cpprstax
+{
+
+TranscodingInputStream::TranscodingInputStream(std::istream& aSource, const TranscodingStreamBuffer::Encoding& eEncoding):
+  std::istream(nullptr),
+  m_aBuffer(aSource, eEncoding)
+{
+    rdbuf(&m_aBuffer);
+}
+
+/**
+ * @brief Maps a byte offset of the UTF-8 representation that is read from
+ *     this stream to the byte offset in the source input.
+ */
+std::streamoff TranscodingInputStream::getSourceOffset(const std::streamoff& nOffset)
+{
+    return m_aBuffer.getSourceOffset(nOffset);
+}
+
+}
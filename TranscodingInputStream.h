@@ -0,0 +1,47 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/TranscodingInputStream.h
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_TRANSCODINGINPUTSTREAM_H
+#define _CPPRSTAX_TRANSCODINGINPUTSTREAM_H
+
+#include "TranscodingStreamBuffer.h"
+#include <istream>
+
+namespace cpprstax
+{
+
+class TranscodingInputStream : public std::istream
+{
+public:
+    TranscodingInputStream(std::istream& aSource, const TranscodingStreamBuffer::Encoding& eEncoding);
+
+public:
+    std::streamoff getSourceOffset(const std::streamoff& nOffset);
+
+protected:
+    TranscodingStreamBuffer m_aBuffer;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,824 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/TranscodingStreamBuffer.cpp
+ * @details The source is transcoded in blocks. For every block, the source
+ *     offset and the UTF-8 offset where it begins are recorded, so seeking to
+ *     an arbitrary UTF-8 offset (which XMLEventReader::rget() does for every
+ *     byte in reverse direction) only needs to transcode the one block that
+ *     contains it again.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "TranscodingStreamBuffer.h"
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+namespace cpprstax
+{
+
+/**
+ * @brief Amount of source bytes transcoded at once. Needs to be even
+ *     for UTF-16.
+ */
+const std::size_t BLOCK_SIZE = 65536;
+
+static std::size_t EncodeUTF8(const unsigned long& nCodePoint, unsigned char* pTarget);
+static std::size_t TranscodeUTF16(const unsigned char* pSource, const std::size_t& nLength, const bool& bBigEndian, unsigned char* pTarget);
+static std::size_t TranscodeISO88591(const unsigned char* pSource, const std::size_t& nLength, unsigned char* pTarget);
+static bool IsBlockOffsetLess(const std::streamoff& nOffset, const std::pair<std::streamoff, std::streamoff>& aBlock);
+
+
+
+TranscodingStreamBuffer::TranscodingStreamBuffer(std::istream& aSource, const Encoding& eEncoding):
+  m_aSource(aSource),
+  m_eEncoding(eEncoding),
+  m_nSourceBegin(aSource.tellg()),
+  m_aSourceBlock(BLOCK_SIZE),
+  m_aBuffer(BLOCK_SIZE * 2),
+  m_bIndexComplete(false),
+  m_nCurrentBlock(0),
+  m_nBufferOffset(0)
+{
+    if (m_nSourceBegin < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    char cBytes[3] = { '\0', '\0', '\0' };
+    m_aSource.read(cBytes, 3);
+    std::streamsize nCount(m_aSource.gcount());
+
+    if (m_aSource.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+
+    m_aSource.clear();
+    m_aSource.seekg(m_nSourceBegin);
+
+    if (m_aSource.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    const unsigned char* pBytes(reinterpret_cast<const unsigned char*>(cBytes));
+    std::streamoff nByteOrderMarkLength(0);
+
+    if (m_eEncoding == ENCODING_UTF8)
+    {
+        if (nCount >= 3 &&
+            pBytes[0] == 0xEF &&
+            pBytes[1] == 0xBB &&
+            pBytes[2] == 0xBF)
+        {
+            nByteOrderMarkLength = 3;
+        }
+    }
+    else if (m_eEncoding == ENCODING_UTF16LE)
+    {
+        if (nCount >= 2 &&
+            pBytes[0] == 0xFF &&
+            pBytes[1] == 0xFE)
+        {
+            nByteOrderMarkLength = 2;
+        }
+    }
+    else if (m_eEncoding == ENCODING_UTF16BE)
+    {
+        if (nCount >= 2 &&
+            pBytes[0] == 0xFE &&
+            pBytes[1] == 0xFF)
+        {
+            nByteOrderMarkLength = 2;
+        }
+    }
+
+    m_aBlocks.push_back(std::pair<std::streamoff, std::streamoff>(nByteOrderMarkLength, 0));
+
+    char* pBuffer(m_aBuffer.data());
+    setg(pBuffer, pBuffer, pBuffer);
+}
+
+/**
+ * @brief Determines the encoding of the input from a byte order mark, the
+ *     byte pattern of "<?" or the encoding declared in the XML declaration.
+ *     The position of aSource is left unchanged.
+ * @details Only the first 256 bytes are looked at, so an encoding declared
+ *     after them is ignored. ASCII-compatible encodings other than UTF-8
+ *     and ISO-8859-1 are read as UTF-8, as are inputs with a malformed
+ *     declaration, unless bStrict.
+ * @param[in] bStrict Throw for every encoding that isn't supported and for
+ *     malformed declarations.
+ * @param[out] bByteOrderMark Whether the input starts with a byte order mark.
+ */
+TranscodingStreamBuffer::Encoding TranscodingStreamBuffer::DetectEncoding(std::istream& aSource, const bool& bStrict, bool& bByteOrderMark)
+{
+    std::streampos nBegin(aSource.tellg());
+
+    if (nBegin < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    const std::streamsize DECLARATION_LENGTH_MAX = 256;
+    char cBytes[DECLARATION_LENGTH_MAX];
+
+    aSource.read(cBytes, DECLARATION_LENGTH_MAX);
+    std::streamsize nCount(aSource.gcount());
+
+    if (aSource.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+
+    aSource.clear();
+    aSource.seekg(nBegin);
+
+    if (aSource.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    const unsigned char* pBytes(reinterpret_cast<const unsigned char*>(cBytes));
+
+    bByteOrderMark = false;
+
+    if (nCount >= 3 &&
+        pBytes[0] == 0xEF &&
+        pBytes[1] == 0xBB &&
+        pBytes[2] == 0xBF)
+    {
+        bByteOrderMark = true;
+        return ENCODING_UTF8;
+    }
+    else if (nCount >= 2 &&
+             pBytes[0] == 0xFF &&
+             pBytes[1] == 0xFE)
+    {
+        bByteOrderMark = true;
+        return ENCODING_UTF16LE;
+    }
+    else if (nCount >= 2 &&
+             pBytes[0] == 0xFE &&
+             pBytes[1] == 0xFF)
+    {
+        bByteOrderMark = true;
+        return ENCODING_UTF16BE;
+    }
+    else if (nCount >= 4 &&
+             pBytes[0] == 0x3C &&
+             pBytes[1] == 0x00 &&
+             pBytes[2] == 0x3F &&
+             pBytes[3] == 0x00)
+    {
+        return ENCODING_UTF16LE;
+    }
+    else if (nCount >= 4 &&
+             pBytes[0] == 0x00 &&
+             pBytes[1] == 0x3C &&
+             pBytes[2] == 0x00 &&
+             pBytes[3] == 0x3F)
+    {
+        return ENCODING_UTF16BE;
+    }
+
+    // ASCII-compatible, but the XML declaration might name
+    // a single-byte encoding other than UTF-8.
+
+    std::string strEncoding;
+
+    if (ReadDeclaredEncoding(std::string(cBytes, nCount), strEncoding) != true)
+    {
+        if (bStrict == true)
+        {
+            throw new std::runtime_error("Encoding declaration is malformed.");
+        }
+
+        return ENCODING_UTF8;
+    }
+
+    for (std::string::iterator iter = strEncoding.begin();
+         iter != strEncoding.end();
+         iter++)
+    {
+        if (*iter >= 'a' &&
+            *iter <= 'z')
+        {
+            *iter = *iter - 'a' + 'A';
+        }
+    }
+
+    if (strEncoding.empty() == true ||
+        strEncoding == "UTF-8" ||
+        strEncoding == "UTF8" ||
+        strEncoding == "US-ASCII" ||
+        strEncoding == "ASCII")
+    {
+        return ENCODING_UTF8;
+    }
+    else if (strEncoding == "ISO-8859-1" ||
+             strEncoding == "ISO8859-1" ||
+             strEncoding == "ISO_8859-1" ||
+             strEncoding == "LATIN1" ||
+             strEncoding == "LATIN-1" ||
+             strEncoding == "L1")
+    {
+        return ENCODING_ISO88591;
+    }
+
+    if (strEncoding.compare(0, 6, "UTF-16") == 0 ||
+        strEncoding.compare(0, 6, "UTF-32") == 0 ||
+        strEncoding.compare(0, 5, "UCS-2") == 0 ||
+        strEncoding.compare(0, 5, "UCS-4") == 0 ||
+        strEncoding.compare(0, 6, "EBCDIC") == 0)
+    {
+        // Without a byte order mark, the bytes of "<?xml" say otherwise.
+        std::stringstream aMessage;
+        aMessage << "Encoding '" << strEncoding << "' is declared for ASCII-compatible input.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    if (bStrict == true)
+    {
+        std::stringstream aMessage;
+        aMessage << "Encoding '" << strEncoding << "' isn't supported.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    // Other ASCII-compatible encodings like windows-1252 are passed
+    // through as bytes, as if they were UTF-8.
+    return ENCODING_UTF8;
+}
+
+/**
+ * @brief Extracts the value of the encoding pseudo-attribute from the
+ *     beginning of the input.
+ * @param[out] strEncoding Empty if there's no XML declaration or no
+ *     encoding declared in it.
+ * @retval false if the declaration is malformed or incomplete.
+ */
+bool TranscodingStreamBuffer::ReadDeclaredEncoding(const std::string& strBegin, std::string& strEncoding)
+{
+    strEncoding.clear();
+
+    if (strBegin.compare(0, 5, "<?xml") != 0)
+    {
+        return true;
+    }
+
+    std::size_t nEnd(strBegin.find("?>"));
+
+    if (nEnd == std::string::npos)
+    {
+        nEnd = strBegin.length();
+    }
+
+    std::size_t nPosition(strBegin.find("encoding"));
+
+    if (nPosition == std::string::npos ||
+        nPosition >= nEnd)
+    {
+        return true;
+    }
+
+    nPosition = strBegin.find_first_not_of(" \t\r\n", nPosition + 8);
+
+    if (nPosition >= nEnd ||
+        strBegin.at(nPosition) != '=')
+    {
+        return false;
+    }
+
+    nPosition = strBegin.find_first_not_of(" \t\r\n", nPosition + 1);
+
+    if (nPosition >= nEnd ||
+        (strBegin.at(nPosition) != '"' &&
+         strBegin.at(nPosition) != '\''))
+    {
+        return false;
+    }
+
+    std::size_t nValueEnd(strBegin.find(strBegin.at(nPosition), nPosition + 1));
+
+    if (nValueEnd >= nEnd)
+    {
+        return false;
+    }
+
+    strEncoding = strBegin.substr(nPosition + 1, nValueEnd - nPosition - 1);
+
+    return true;
+}
+
+/**
+ * @param[in] nOffset Byte offset in the UTF-8 representation.
+ * @retval Byte offset of the corresponding character in the source input,
+ *     counted from the position the source had when this object was
+ *     created, including the byte order mark.
+ */
+std::streamoff TranscodingStreamBuffer::getSourceOffset(const std::streamoff& nOffset)
+{
+    std::streamoff nPosition(m_nBufferOffset + (gptr() - eback()));
+
+    if (seekpos(nOffset, std::ios_base::in) != pos_type(nOffset))
+    {
+        throw new std::invalid_argument("Offset is beyond the end of the input.");
+    }
+
+    std::streamoff nSourceOffset(m_aBlocks.at(m_nCurrentBlock).first);
+
+    if (m_nCurrentBlock + 1 < m_aBlocks.size())
+    {
+        const unsigned char* pSource(reinterpret_cast<const unsigned char*>(m_aSourceBlock.data()));
+        std::size_t nSourceLength(m_aBlocks.at(m_nCurrentBlock + 1).first - nSourceOffset);
+        std::streamoff nSkip(nOffset - m_nBufferOffset);
+        std::size_t nConsumed(0);
+
+        // Count source characters up to the one that produced
+        // the UTF-8 byte at nOffset.
+        while (nConsumed < nSourceLength)
+        {
+            std::size_t nCharacterLength(1);
+            std::streamoff nProduced(1);
+
+            if (m_eEncoding == ENCODING_ISO88591)
+            {
+                nProduced = pSource[nConsumed] < 0x80 ? 1 : 2;
+            }
+            else if (m_eEncoding == ENCODING_UTF16LE ||
+                     m_eEncoding == ENCODING_UTF16BE)
+            {
+                std::size_t nHigh(m_eEncoding == ENCODING_UTF16BE ? 0 : 1);
+                unsigned int nUnit((pSource[nConsumed + nHigh] << 8) | pSource[nConsumed + 1 - nHigh]);
+
+                nCharacterLength = 2;
+
+                if (nUnit < 0x80)
+                {
+                    nProduced = 1;
+                }
+                else if (nUnit < 0x800)
+                {
+                    nProduced = 2;
+                }
+                else if (nUnit >= 0xD800 &&
+                         nUnit <= 0xDBFF &&
+                         nConsumed + 4 <= nSourceLength)
+                {
+                    unsigned int nLowUnit((pSource[nConsumed + 2 + nHigh] << 8) | pSource[nConsumed + 3 - nHigh]);
+
+                    if (nLowUnit >= 0xDC00 &&
+                        nLowUnit <= 0xDFFF)
+                    {
+                        nCharacterLength = 4;
+                        nProduced = 4;
+                    }
+                    else
+                    {
+                        nProduced = 3;
+                    }
+                }
+                else
+                {
+                    nProduced = 3;
+                }
+            }
+
+            if (nSkip < nProduced)
+            {
+                break;
+            }
+
+            nSkip -= nProduced;
+            nConsumed += nCharacterLength;
+        }
+
+        nSourceOffset += nConsumed;
+    }
+
+    seekpos(nPosition, std::ios_base::in);
+
+    return nSourceOffset;
+}
+
+TranscodingStreamBuffer::int_type TranscodingStreamBuffer::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamoff nPosition(m_nBufferOffset + (egptr() - eback()));
+
+    if (seekpos(nPosition, std::ios_base::in) != pos_type(nPosition))
+    {
+        return traits_type::eof();
+    }
+
+    if (gptr() >= egptr())
+    {
+        return traits_type::eof();
+    }
+
+    return traits_type::to_int_type(*gptr());
+}
+
+TranscodingStreamBuffer::int_type TranscodingStreamBuffer::pbackfail(int_type c)
+{
+    std::streamoff nPosition(m_nBufferOffset + (gptr() - eback()));
+
+    if (nPosition <= 0)
+    {
+        return traits_type::eof();
+    }
+
+    if (seekpos(nPosition - 1, std::ios_base::in) != pos_type(nPosition - 1))
+    {
+        return traits_type::eof();
+    }
+
+    if (traits_type::eq_int_type(c, traits_type::eof()) != true &&
+        traits_type::eq_int_type(c, traits_type::to_int_type(*gptr())) != true)
+    {
+        // Putting back a different character isn't supported.
+        gbump(1);
+        return traits_type::eof();
+    }
+
+    return traits_type::to_int_type(*gptr());
+}
+
+TranscodingStreamBuffer::pos_type TranscodingStreamBuffer::seekoff(off_type nOffset, std::ios_base::seekdir eDirection, std::ios_base::openmode nMode)
+{
+    if ((nMode & std::ios_base::in) == 0)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    std::streamoff nTarget(nOffset);
+
+    if (eDirection == std::ios_base::cur)
+    {
+        nTarget += m_nBufferOffset + (gptr() - eback());
+
+        // Stays within the current block, which is the common
+        // case for tellg() and XMLEventReader::rget().
+        if (nTarget >= m_nBufferOffset &&
+            nTarget <= m_nBufferOffset + (egptr() - eback()))
+        {
+            setg(eback(), eback() + (nTarget - m_nBufferOffset), egptr());
+            return pos_type(nTarget);
+        }
+    }
+    else if (eDirection == std::ios_base::end)
+    {
+        CompleteIndex();
+        nTarget += m_aBlocks.back().second;
+    }
+
+    return seekpos(pos_type(nTarget), nMode);
+}
+
+TranscodingStreamBuffer::pos_type TranscodingStreamBuffer::seekpos(pos_type nPosition, std::ios_base::openmode nMode)
+{
+    std::streamoff nTarget(nPosition);
+
+    if ((nMode & std::ios_base::in) == 0 ||
+        nTarget < 0)
+    {
+        return pos_type(off_type(-1));
+    }
+
+    while (m_bIndexComplete != true &&
+           nTarget >= m_aBlocks.back().second)
+    {
+        LoadBlock(m_aBlocks.size() - 1);
+    }
+
+    if (nTarget > m_aBlocks.back().second)
+    {
+        return pos_type(off_type(-1));
+    }
+    else if (nTarget == m_aBlocks.back().second)
+    {
+        // End of input.
+        char* pBuffer(m_aBuffer.data());
+        setg(pBuffer, pBuffer, pBuffer);
+        m_nCurrentBlock = m_aBlocks.size() - 1;
+        m_nBufferOffset = nTarget;
+
+        return nPosition;
+    }
+
+    std::vector<std::pair<std::streamoff, std::streamoff>>::iterator iter = std::upper_bound(m_aBlocks.begin(),
+                                                                                             m_aBlocks.end(),
+                                                                                             nTarget,
+                                                                                             IsBlockOffsetLess);
+    std::size_t nBlock((iter - m_aBlocks.begin()) - 1);
+
+    if (nBlock != m_nCurrentBlock ||
+        eback() == egptr())
+    {
+        LoadBlock(nBlock);
+    }
+
+    setg(eback(), eback() + (nTarget - m_nBufferOffset), egptr());
+
+    return nPosition;
+}
+
+/**
+ * @retval Returns false if nBlock turned out to be the end of the input.
+ */
+bool TranscodingStreamBuffer::LoadBlock(const std::size_t& nBlock)
+{
+    m_aSource.clear();
+    m_aSource.seekg(m_nSourceBegin + m_aBlocks.at(nBlock).first);
+
+    if (m_aSource.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    m_aSource.read(m_aSourceBlock.data(), BLOCK_SIZE);
+
+    if (m_aSource.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+
+    std::size_t nCount(m_aSource.gcount());
+    bool bEnd(m_aSource.eof());
+
+    m_aSource.clear();
+
+    if (nCount <= 0)
+    {
+        if (nBlock + 1 == m_aBlocks.size())
+        {
+            m_bIndexComplete = true;
+        }
+
+        return false;
+    }
+
+    const unsigned char* pSource(reinterpret_cast<const unsigned char*>(m_aSourceBlock.data()));
+    unsigned char* pTarget(reinterpret_cast<unsigned char*>(m_aBuffer.data()));
+    std::size_t nConsumed(nCount);
+    std::size_t nProduced(0);
+
+    if (m_eEncoding == ENCODING_UTF16LE ||
+        m_eEncoding == ENCODING_UTF16BE)
+    {
+        if (nConsumed % 2 != 0)
+        {
+            throw new std::runtime_error("UTF-16 input ends within a code unit.");
+        }
+
+        // A surrogate pair must not be split across blocks.
+        if (bEnd != true)
+        {
+            unsigned char cHigh(m_eEncoding == ENCODING_UTF16BE ? pSource[nConsumed - 2] : pSource[nConsumed - 1]);
+
+            if (cHigh >= 0xD8 &&
+                cHigh <= 0xDB)
+            {
+                nConsumed -= 2;
+            }
+        }
+
+        nProduced = TranscodeUTF16(pSource, nConsumed, m_eEncoding == ENCODING_UTF16BE, pTarget);
+    }
+    else if (m_eEncoding == ENCODING_ISO88591)
+    {
+        nProduced = TranscodeISO88591(pSource, nConsumed, pTarget);
+    }
+    else
+    {
+        std::memcpy(pTarget, pSource, nConsumed);
+        nProduced = nConsumed;
+    }
+
+    if (nBlock + 1 == m_aBlocks.size())
+    {
+        m_aBlocks.push_back(std::pair<std::streamoff, std::streamoff>(m_aBlocks.at(nBlock).first + nConsumed,
+                                                                      m_aBlocks.at(nBlock).second + nProduced));
+
+        if (bEnd == true)
+        {
+            m_bIndexComplete = true;
+        }
+    }
+
+    char* pBuffer(m_aBuffer.data());
+    setg(pBuffer, pBuffer, pBuffer + nProduced);
+    m_nCurrentBlock = nBlock;
+    m_nBufferOffset = m_aBlocks.at(nBlock).second;
+
+    return true;
+}
+
+/**
+ * @brief Transcodes the remaining input to learn its length in UTF-8,
+ *     as needed for seeking relative to the end.
+ */
+bool TranscodingStreamBuffer::CompleteIndex()
+{
+    while (m_bIndexComplete != true)
+    {
+        LoadBlock(m_aBlocks.size() - 1);
+    }
+
+    return true;
+}
+
+std::size_t EncodeUTF8(const unsigned long& nCodePoint, unsigned char* pTarget)
+{
+    if (nCodePoint < 0x80)
+    {
+        pTarget[0] = static_cast<unsigned char>(nCodePoint);
+        return 1;
+    }
+    else if (nCodePoint < 0x800)
+    {
+        pTarget[0] = static_cast<unsigned char>(0xC0 | (nCodePoint >> 6));
+        pTarget[1] = static_cast<unsigned char>(0x80 | (nCodePoint & 0x3F));
+        return 2;
+    }
+    else if (nCodePoint < 0x10000)
+    {
+        pTarget[0] = static_cast<unsigned char>(0xE0 | (nCodePoint >> 12));
+        pTarget[1] = static_cast<unsigned char>(0x80 | ((nCodePoint >> 6) & 0x3F));
+        pTarget[2] = static_cast<unsigned char>(0x80 | (nCodePoint & 0x3F));
+        return 3;
+    }
+    else
+    {
+        pTarget[0] = static_cast<unsigned char>(0xF0 | (nCodePoint >> 18));
+        pTarget[1] = static_cast<unsigned char>(0x80 | ((nCodePoint >> 12) & 0x3F));
+        pTarget[2] = static_cast<unsigned char>(0x80 | ((nCodePoint >> 6) & 0x3F));
+        pTarget[3] = static_cast<unsigned char>(0x80 | (nCodePoint & 0x3F));
+        return 4;
+    }
+}
+
+/**
+ * @details Runs of ASCII are handled four code units at a time with a single
+ *     test of an eight byte word. The mask is built in memory order, so it
+ *     doesn't depend on the byte order of the host. Unpaired surrogates are
+ *     replaced by U+FFFD.
+ */
+std::size_t TranscodeUTF16(const unsigned char* pSource, const std::size_t& nLength, const bool& bBigEndian, unsigned char* pTarget)
+{
+    static const unsigned char MASK_LE[8] = { 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF };
+    static const unsigned char MASK_BE[8] = { 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80, 0xFF, 0x80 };
+
+    std::uint64_t nMask(0);
+    std::memcpy(&nMask, bBigEndian == true ? MASK_BE : MASK_LE, sizeof(nMask));
+
+    const std::size_t nLow(bBigEndian == true ? 1 : 0);
+    const std::size_t nHigh(1 - nLow);
+    std::size_t nConsumed(0);
+    std::size_t nProduced(0);
+
+    while (nConsumed < nLength)
+    {
+        while (nConsumed + 8 <= nLength)
+        {
+            std::uint64_t nWord(0);
+            std::memcpy(&nWord, pSource + nConsumed, sizeof(nWord));
+
+            if ((nWord & nMask) != 0)
+            {
+                break;
+            }
+
+            pTarget[nProduced] = pSource[nConsumed + nLow];
+            pTarget[nProduced + 1] = pSource[nConsumed + 2 + nLow];
+            pTarget[nProduced + 2] = pSource[nConsumed + 4 + nLow];
+            pTarget[nProduced + 3] = pSource[nConsumed + 6 + nLow];
+
+            nConsumed += 8;
+            nProduced += 4;
+        }
+
+        if (nConsumed >= nLength)
+        {
+            break;
+        }
+
+        unsigned long nCodePoint((pSource[nConsumed + nHigh] << 8) | pSource[nConsumed + nLow]);
+        nConsumed += 2;
+
+        if (nCodePoint >= 0xD800 &&
+            nCodePoint <= 0xDBFF)
+        {
+            if (nConsumed + 2 <= nLength)
+            {
+                unsigned long nLowUnit((pSource[nConsumed + nHigh] << 8) | pSource[nConsumed + nLow]);
+
+                if (nLowUnit >= 0xDC00 &&
+                    nLowUnit <= 0xDFFF)
+                {
+                    nCodePoint = 0x10000 + ((nCodePoint - 0xD800) << 10) + (nLowUnit - 0xDC00);
+                    nConsumed += 2;
+                }
+                else
+                {
+                    nCodePoint = 0xFFFD;
+                }
+            }
+            else
+            {
+                nCodePoint = 0xFFFD;
+            }
+        }
+        else if (nCodePoint >= 0xDC00 &&
+                 nCodePoint <= 0xDFFF)
+        {
+            nCodePoint = 0xFFFD;
+        }
+
+        nProduced += EncodeUTF8(nCodePoint, pTarget + nProduced);
+    }
+
+    return nProduced;
+}
+
+/**
+ * @details Runs of ASCII are copied eight bytes at a time.
+ */
+std::size_t TranscodeISO88591(const unsigned char* pSource, const std::size_t& nLength, unsigned char* pTarget)
+{
+    const std::uint64_t nMask(0x8080808080808080ULL);
+    std::size_t nConsumed(0);
+    std::size_t nProduced(0);
+
+    while (nConsumed < nLength)
+    {
+        while (nConsumed + 8 <= nLength)
+        {
+            std::uint64_t nWord(0);
+            std::memcpy(&nWord, pSource + nConsumed, sizeof(nWord));
+
+            if ((nWord & nMask) != 0)
+            {
+                break;
+            }
+
+            std::memcpy(pTarget + nProduced, &nWord, sizeof(nWord));
+
+            nConsumed += 8;
+            nProduced += 8;
+        }
+
+        if (nConsumed >= nLength)
+        {
+            break;
+        }
+
+        unsigned char cByte(pSource[nConsumed]);
+        ++nConsumed;
+
+        if (cByte < 0x80)
+        {
+            pTarget[nProduced] = cByte;
+            ++nProduced;
+        }
+        else
+        {
+            pTarget[nProduced] = static_cast<unsigned char>(0xC0 | (cByte >> 6));
+            pTarget[nProduced + 1] = static_cast<unsigned char>(0x80 | (cByte & 0x3F));
+            nProduced += 2;
+        }
+    }
+
+    return nProduced;
+}
+
+bool IsBlockOffsetLess(const std::streamoff& nOffset, const std::pair<std::streamoff, std::streamoff>& aBlock)
+{
+    return nOffset < aBlock.second;
+}
+
+}
@@ -0,0 +1,87 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/TranscodingStreamBuffer.h
+ * @brief Input stage that presents UTF-16 or ISO-8859-1 input as UTF-8
+ *     to the lexer, including seeking as needed for reverse reading.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_TRANSCODINGSTREAMBUFFER_H
+#define _CPPRSTAX_TRANSCODINGSTREAMBUFFER_H
+
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace cpprstax
+{
+
+class TranscodingStreamBuffer : public std::streambuf
+{
+public:
+    enum Encoding
+    {
+        ENCODING_UTF8,
+        ENCODING_UTF16LE,
+        ENCODING_UTF16BE,
+        ENCODING_ISO88591
+    };
+
+public:
+    TranscodingStreamBuffer(std::istream& aSource, const Encoding& eEncoding);
+
+public:
+    static Encoding DetectEncoding(std::istream& aSource, const bool& bStrict, bool& bByteOrderMark);
+
+    std::streamoff getSourceOffset(const std::streamoff& nOffset);
+
+protected:
+    virtual int_type underflow();
+    virtual int_type pbackfail(int_type c);
+    virtual pos_type seekoff(off_type nOffset, std::ios_base::seekdir eDirection, std::ios_base::openmode nMode);
+    virtual pos_type seekpos(pos_type nPosition, std::ios_base::openmode nMode);
+
+protected:
+    static bool ReadDeclaredEncoding(const std::string& strBegin, std::string& strEncoding);
+    bool LoadBlock(const std::size_t& nBlock);
+    bool CompleteIndex();
+
+protected:
+    std::istream& m_aSource;
+    Encoding m_eEncoding;
+    std::streampos m_nSourceBegin;
+    std::vector<char> m_aSourceBlock;
+    std::vector<char> m_aBuffer;
+    /**
+     * Pairs of source byte offset and UTF-8 byte offset at which the
+     * blocks start. The last entry is the start of the block that wasn't
+     * read yet or, if m_bIndexComplete, the end of the input.
+     */
+    std::vector<std::pair<std::streamoff, std::streamoff>> m_aBlocks;
+    bool m_bIndexComplete;
+    std::size_t m_nCurrentBlock;
+    std::streamoff m_nBufferOffset;
+
+};
+
+}
+
+#endif
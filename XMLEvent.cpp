@@ -144,4 +144,59 @@ ProcessingInstruction& XMLEvent::asProcessingInstruction()
     return *m_pProcessingInstruction;
 }
 
+/**
+ * @brief Deep copy, so the copy stays valid independent of the original.
+ */
+std::unique_ptr<XMLEvent> XMLEvent::clone() const
+{
+    if (m_pStartElement != nullptr)
+    {
+        const QName& aName(m_pStartElement->getName());
+        std::unique_ptr<QName> pName(new QName(aName.getNamespaceURI(), aName.getLocalPart(), aName.getPrefix()));
+        std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
+
+        for (std::list<std::shared_ptr<Attribute>>::iterator iter = m_pStartElement->getAttributes()->begin();
+             iter != m_pStartElement->getAttributes()->end();
+             iter++)
+        {
+            const QName& aAttributeName((*iter)->getName());
+            std::unique_ptr<QName> pAttributeName(new QName(aAttributeName.getNamespaceURI(), aAttributeName.getLocalPart(), aAttributeName.getPrefix()));
+            std::unique_ptr<std::string> pValue(new std::string((*iter)->getValue()));
+
+            pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pValue))));
+        }
+
+        std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
+
+        return std::unique_ptr<XMLEvent>(new XMLEvent(std::move(pStartElement), nullptr, nullptr, nullptr, nullptr));
+    }
+    else if (m_pEndElement != nullptr)
+    {
+        const QName& aName(m_pEndElement->getName());
+        std::unique_ptr<QName> pName(new QName(aName.getNamespaceURI(), aName.getLocalPart(), aName.getPrefix()));
+        std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
+
+        return std::unique_ptr<XMLEvent>(new XMLEvent(nullptr, std::move(pEndElement), nullptr, nullptr, nullptr));
+    }
+    else if (m_pCharacters != nullptr)
+    {
+        std::unique_ptr<Characters> pCharacters(new Characters(std::unique_ptr<std::string>(new std::string(m_pCharacters->getData()))));
+
+        return std::unique_ptr<XMLEvent>(new XMLEvent(nullptr, nullptr, std::move(pCharacters), nullptr, nullptr));
+    }
+    else if (m_pComment != nullptr)
+    {
+        std::unique_ptr<Comment> pComment(new Comment(std::unique_ptr<std::string>(new std::string(m_pComment->getText()))));
+
+        return std::unique_ptr<XMLEvent>(new XMLEvent(nullptr, nullptr, nullptr, std::move(pComment), nullptr));
+    }
+    else
+    {
+        std::unique_ptr<ProcessingInstruction> pProcessingInstruction(new ProcessingInstruction(std::unique_ptr<std::string>(new std::string(m_pProcessingInstruction->getTarget())),
+                                                                                                  std::unique_ptr<std::string>(new std::string(m_pProcessingInstruction->getData()))));
+
+        return std::unique_ptr<XMLEvent>(new XMLEvent(nullptr, nullptr, nullptr, nullptr, std::move(pProcessingInstruction)));
+    }
+}
+
 }
@@ -54,6 +54,9 @@ public:
     bool isProcessingInstruction();
     ProcessingInstruction& asProcessingInstruction();
 
+public:
+    std::unique_ptr<XMLEvent> clone() const;
+
 protected:
     std::unique_ptr<StartElement> m_pStartElement;
     std::unique_ptr<EndElement> m_pEndElement;
@@ -43,6 +43,9 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <vector>
+#include <cstring>
+#include <limits>
 
 namespace cpprstax
 {
@@ -51,25 +54,34 @@ XMLEventReader::XMLEventReader(std::istream& aStream):
   m_aStream(aStream),
   m_bHasNextCalled(false),
   m_bHasPreviousCalled(false),
-  m_bEventsAreForwardDirection(true)
+  m_bEventsAreForwardDirection(true),
+  m_nEventMask(MASK_NONE),
+  m_pEntityTable(EntityTable::getDefault()),
+  m_nHistorySize(0),
+  m_nHistoryEvents(0),
+  m_nHistoryCursor(0),
+  m_bHistorySeek(false),
+  m_bHistoryLexing(false),
+  m_nCheckpointInterval(0),
+  m_nCheckpointEvents(0),
+  m_bTrackElements(false),
+  m_bOpenElementsKnown(true),
+  m_nFilterDepth(0)
 {
-    m_aEntityReplacementDictionary.insert(std::pair<std::string, std::string>("amp", "&"));
-    m_aEntityReplacementDictionary.insert(std::pair<std::string, std::string>("lt", "<"));
-    m_aEntityReplacementDictionary.insert(std::pair<std::string, std::string>("gt", ">"));
-    m_aEntityReplacementDictionary.insert(std::pair<std::string, std::string>("apos", "'"));
-    m_aEntityReplacementDictionary.insert(std::pair<std::string, std::string>("quot", "\""));
-
-    m_aREntityReplacementDictionary.insert(std::pair<std::string, std::string>("pma", "&"));
-    m_aREntityReplacementDictionary.insert(std::pair<std::string, std::string>("tl", "<"));
-    m_aREntityReplacementDictionary.insert(std::pair<std::string, std::string>("tg", ">"));
-    m_aREntityReplacementDictionary.insert(std::pair<std::string, std::string>("sopa", "'"));
-    m_aREntityReplacementDictionary.insert(std::pair<std::string, std::string>("touq", "\""));
+    // More entities come from a catalogue, see EntityTable::addCatalogue(),
+    // which is best loaded once and saved with EntityTable::writeSnapshot(),
+    // so readers can start with EntityTable::loadSnapshot() and
+    // XMLEventReader::setEntityTable().
+}
 
-    /** @todo Load more from a catalogue, which itself is written in XML and needs to be read
-      * in here by another local XMLEventReader object, containing mappings from entity to
-      * replacement characters. No need to deal with DTDs as they're non-XML, and extracting
-      * those mappings from a DTD can be a separate program or manual procedure. Also see
-      * intermediate workaround method XMLEventReader::addToEntityReplacementDictionary(). */
+/**
+ * @brief Reads from a stream the reader takes ownership of, like the
+ *     TranscodingInputStream set up by XMLInputFactory.
+ */
+XMLEventReader::XMLEventReader(std::unique_ptr<std::istream> pStream):
+  XMLEventReader(*pStream)
+{
+    m_pStream = std::move(pStream);
 }
 
 XMLEventReader::~XMLEventReader()
@@ -101,27 +113,33 @@ bool XMLEventReader::hasNext()
         m_bHasNextCalled = true;
     }
 
-    char cByte('\0');
-    m_aStream.get(cByte);
-
-    if (m_aStream.eof() == true)
+    if (m_nCheckpointInterval > 0 &&
+        m_nCheckpointEvents >= m_nCheckpointInterval &&
+        m_bOpenElementsKnown == true &&
+        m_bHistoryLexing != true)
     {
-        return false;
+        m_nCheckpointEvents = 0;
+        m_aCheckpointHandler(checkpoint());
     }
 
-    if (m_aStream.bad() == true)
+    if (m_nHistorySize > 0 &&
+        m_bHistoryLexing != true)
     {
-        throw new std::runtime_error("Stream is bad.");
+        return HistoryNext();
     }
 
-    if (cByte == '<')
-    {
-        return HandleTag();
-    }
-    else
+    while (HandleToken() != true)
     {
-        return HandleText(cByte);
+        if (m_bHasNextCalled == true)
+        {
+            return false;
+        }
+
+        // The token was skipped, so on to the next one.
+        m_bHasNextCalled = true;
     }
+
+    return true;
 }
 
 std::unique_ptr<XMLEvent> XMLEventReader::nextEvent()
@@ -151,11 +169,58 @@ std::unique_ptr<XMLEvent> XMLEventReader::nextEvent()
     std::unique_ptr<XMLEvent> pEvent(std::move(m_aEvents.front()));
     m_aEvents.pop();
 
+    if (m_bTrackElements == true)
+    {
+        TrackElement(*pEvent);
+    }
+
     return std::move(pEvent);
 }
 
+/**
+ * @brief Moves up to nMax next events into pEvents, with the checks of
+ *     hasNext() and nextEvent() done once per token instead of per event.
+ * @retval Number of events retrieved, less than nMax only at the end of
+ *     the input.
+ */
+std::size_t XMLEventReader::nextEvents(std::unique_ptr<XMLEvent>* pEvents, const std::size_t& nMax)
+{
+    std::size_t nCount(0);
+
+    while (nCount < nMax)
+    {
+        if (hasNext() != true)
+        {
+            break;
+        }
+
+        while (nCount < nMax &&
+               m_aEvents.empty() != true)
+        {
+            pEvents[nCount] = std::move(m_aEvents.front());
+            m_aEvents.pop();
+
+            if (m_bTrackElements == true)
+            {
+                TrackElement(*pEvents[nCount]);
+            }
+
+            ++nCount;
+        }
+
+        m_bHasNextCalled = false;
+    }
+
+    return nCount;
+}
+
 bool XMLEventReader::hasPrevious()
 {
+    if (m_aFilterPaths.empty() != true)
+    {
+        throw new std::logic_error("Attempted XMLEventReader::hasPrevious() with a path filter, which only supports reading forward.");
+    }
+
     if (m_bHasNextCalled == true ||
         m_bEventsAreForwardDirection == true)
     {
@@ -178,21 +243,24 @@ bool XMLEventReader::hasPrevious()
         m_bHasPreviousCalled = true;
     }
 
-    char cByte('\0');
-
-    if (rget(cByte) != true)
+    if (m_nHistorySize > 0 &&
+        m_bHistoryLexing != true)
     {
-        return false;
+        return HistoryPrevious();
     }
 
-    if (cByte == '>')
-    {
-        return HandleRTag();
-    }
-    else
+    while (HandleRToken() != true)
     {
-        return HandleRText(cByte);
+        if (m_bHasPreviousCalled == true)
+        {
+            return false;
+        }
+
+        // The token was skipped, so on to the previous one.
+        m_bHasPreviousCalled = true;
     }
+
+    return true;
 }
 
 std::unique_ptr<XMLEvent> XMLEventReader::previousEvent()
@@ -222,981 +290,1268 @@ std::unique_ptr<XMLEvent> XMLEventReader::previousEvent()
     std::unique_ptr<XMLEvent> pEvent(std::move(m_aEvents.front()));
     m_aEvents.pop();
 
+    m_bOpenElementsKnown = false;
+
     return std::move(pEvent);
 }
 
-int XMLEventReader::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+/**
+ * @brief Moves up to nMax previous events into pEvents, in the order
+ *     previousEvent() would return them.
+ * @retval Number of events retrieved, less than nMax only at the start of
+ *     the input.
+ */
+std::size_t XMLEventReader::previousEvents(std::unique_ptr<XMLEvent>* pEvents, const std::size_t& nMax)
 {
-    if (strName == "amp" ||
-        strName == "lt" ||
-        strName == "gt" ||
-        strName == "apos" ||
-        strName == "quot")
+    std::size_t nCount(0);
+
+    m_bOpenElementsKnown = false;
+
+    while (nCount < nMax)
     {
-        throw new std::invalid_argument("Redefinition of built-in entity.");
+        if (hasPrevious() != true)
+        {
+            break;
+        }
+
+        while (nCount < nMax &&
+               m_aEvents.empty() != true)
+        {
+            pEvents[nCount] = std::move(m_aEvents.front());
+            m_aEvents.pop();
+            ++nCount;
+        }
+
+        m_bHasPreviousCalled = false;
     }
 
-    m_aEntityReplacementDictionary[strName] = strReplacementText;
-    m_aREntityReplacementDictionary[std::string(strName.rbegin(), strName.rend())] = std::string(strReplacementText.rbegin(), strReplacementText.rend());
-    return 0;
+    return nCount;
 }
 
-bool XMLEventReader::HandleTag()
+/**
+ * @brief Positions the reader at the first markup start ('<') at or after
+ *     nOffset, so reading can continue from there in both directions.
+ * @details '<' can't be part of attribute values or text, but of comments
+ *     and processing instructions. If the last "<!--" or "<?" in the 64 KiB
+ *     before nOffset isn't closed before nOffset, but within 64 KiB after
+ *     it, nOffset is assumed to be inside of it and the search starts after
+ *     its end. Otherwise, the first '<' at or after nOffset is taken. Longer
+ *     comments or processing instructions, a "<!--" or "<?" within other
+ *     markup, or a position inside of a DOCTYPE declaration or CDATA section
+ *     can't be detected.
+ * @retval Offset the reader is positioned at, which is the end of the
+ *     input if there's no markup left.
+ */
+std::streamoff XMLEventReader::seek(const std::streamoff& nOffset)
 {
-    char cByte('\0');
-    m_aStream.get(cByte);
+    ClearHistory();
 
-    if (m_aStream.eof() == true)
+    m_bOpenElementsKnown = false;
+
+    std::queue<std::unique_ptr<XMLEvent>>().swap(m_aEvents);
+    m_bHasNextCalled = false;
+    m_bHasPreviousCalled = false;
+
+    std::streamoff nWindowOffset(nOffset);
+    std::streamoff nCommentStart(-1);
+    std::streamoff nPIStart(-1);
+    std::streamoff nCommentEnd(SeekMarkupEnd(nOffset, "<!--", "-->", nCommentStart));
+    std::streamoff nPIEnd(SeekMarkupEnd(nOffset, "<?", "?>", nPIStart));
+
+    // If both, the one that started earlier contains the other.
+    if (nCommentEnd >= 0 &&
+        (nPIEnd < 0 || nCommentStart < nPIStart))
     {
-        throw new std::runtime_error("Tag incomplete.");
+        nWindowOffset = nCommentEnd;
     }
-
-    if (m_aStream.bad() == true)
+    else if (nPIEnd >= 0)
     {
-        throw new std::runtime_error("Stream is bad.");
+        nWindowOffset = nPIEnd;
     }
 
-    if (cByte == '?')
+    const std::size_t WINDOW_SIZE = 65536;
+    std::vector<char> aBuffer(WINDOW_SIZE);
+
+    do
     {
-        if (HandleProcessingInstruction() == true)
+        m_aStream.clear();
+        m_aStream.seekg(nWindowOffset);
+
+        if (m_aStream.fail() == true)
         {
-            return true;
+            throw new std::runtime_error("Stream operation failed.");
         }
-        else
+
+        m_aStream.read(aBuffer.data(), aBuffer.size());
+
+        if (m_aStream.bad() == true)
         {
-            m_bHasNextCalled = false;
-            return hasNext();
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        std::size_t nCount(m_aStream.gcount());
+
+        if (nCount <= 0)
+        {
+            break;
         }
+
+        const char* pBegin(aBuffer.data());
+        const char* pEnd(pBegin + nCount);
+        const char* pPosition(pBegin);
+
+        const void* pFound(std::memchr(pPosition, '<', pEnd - pPosition));
+
+        if (pFound != nullptr)
+        {
+            nWindowOffset += static_cast<const char*>(pFound) - pBegin;
+            break;
+        }
+
+        nWindowOffset += nCount;
+
+    } while (true);
+
+    m_aStream.clear();
+    m_aStream.seekg(nWindowOffset);
+
+    if (m_aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
     }
-    else if (cByte == '/')
+
+    return nWindowOffset;
+}
+
+/**
+ * @brief Finds the last pStart, like "<!--", before nOffset, and whether
+ *     its pEnd, like "-->", only follows at or after nOffset.
+ * @param[out] nStart Offset of pStart, if there's one.
+ * @retval Offset after pEnd if nOffset is inside, otherwise -1.
+ */
+std::streamoff XMLEventReader::SeekMarkupEnd(const std::streamoff& nOffset, const char* pStart, const char* pEnd, std::streamoff& nStart)
+{
+    const std::streamoff WINDOW_SIZE = 65536;
+    const std::size_t nStartLength(std::strlen(pStart));
+    const std::size_t nEndLength(std::strlen(pEnd));
+
+    if (nOffset <= 0)
     {
-        return HandleTagEnd();
+        return -1;
     }
-    else if (cByte == '!')
+
+    // pStart may reach beyond nOffset, as long as it begins before it.
+    std::streamoff nWindowOffset(std::max(nOffset - WINDOW_SIZE, static_cast<std::streamoff>(0)));
+    std::vector<char> aBuffer(nOffset - nWindowOffset + nStartLength - 1);
+
+    m_aStream.clear();
+    m_aStream.seekg(nWindowOffset);
+
+    if (m_aStream.fail() == true)
     {
-        return HandleMarkupDeclaration();
+        throw new std::runtime_error("Stream operation failed.");
     }
-    else if (std::isalpha(cByte, m_aLocale) == true ||
-             cByte == '_')
+
+    m_aStream.read(aBuffer.data(), aBuffer.size());
+
+    if (m_aStream.bad() == true)
     {
-        return HandleTagStart(cByte);
+        throw new std::runtime_error("Stream is bad.");
     }
-    else
+
+    const char* pBegin(aBuffer.data());
+    const char* pWindowEnd(pBegin + m_aStream.gcount());
+    const char* pFound(std::find_end(pBegin, pWindowEnd, pStart, pStart + nStartLength));
+
+    if (pFound == pWindowEnd)
     {
-        int nByte(cByte);
-        std::stringstream aMessage;
-        aMessage << "Unknown byte '" << cByte << "' (0x"
-                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                 << ") within element.";
-        throw new std::runtime_error(aMessage.str());
+        return -1;
     }
-}
 
-bool XMLEventReader::HandleTagStart(const char& cFirstByte)
-{
-    char cByte('\0');
-    m_aStream.get(cByte);
+    nStart = nWindowOffset + (pFound - pBegin);
 
-    if (m_aStream.eof() == true)
+    // The first pEnd after pStart, up to WINDOW_SIZE after nOffset.
+    nWindowOffset = nStart + nStartLength;
+    aBuffer.resize(nOffset + WINDOW_SIZE - nWindowOffset);
+
+    m_aStream.clear();
+    m_aStream.seekg(nWindowOffset);
+
+    if (m_aStream.fail() == true)
     {
-        throw new std::runtime_error("Tag start incomplete.");
+        throw new std::runtime_error("Stream operation failed.");
     }
 
+    m_aStream.read(aBuffer.data(), aBuffer.size());
+
     if (m_aStream.bad() == true)
     {
         throw new std::runtime_error("Stream is bad.");
     }
 
-    std::unique_ptr<std::string> pNamePrefix(nullptr);
-    std::unique_ptr<std::string> pNameLocalPart(new std::string());
-    std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
+    pBegin = aBuffer.data();
+    pWindowEnd = pBegin + m_aStream.gcount();
+    pFound = std::search(pBegin, pWindowEnd, pEnd, pEnd + nEndLength);
 
-    pNameLocalPart->push_back(cFirstByte);
+    if (pFound == pWindowEnd)
+    {
+        return -1;
+    }
 
-    do
+    std::streamoff nEnd(nWindowOffset + (pFound - pBegin) + nEndLength);
+
+    if (nEnd <= nOffset)
     {
-        if (cByte == ':')
+        return -1;
+    }
+
+    return nEnd;
+}
+
+/**
+ * @brief Positions the reader at the last markup start ('<') at or before
+ *     nOffset, or at the start of the input if there's none.
+ * @details If the start of a comment or processing instruction is found
+ *     before that '<' without the end of one in between (within 64 KiB),
+ *     the '<' is assumed to be inside of it, and the reader is positioned
+ *     at its start instead.
+ * @retval Offset the reader is positioned at.
+ */
+std::streamoff XMLEventReader::seekPrevious(const std::streamoff& nOffset)
+{
+    ClearHistory();
+
+    m_bOpenElementsKnown = false;
+
+    std::queue<std::unique_ptr<XMLEvent>>().swap(m_aEvents);
+    m_bHasNextCalled = false;
+    m_bHasPreviousCalled = false;
+
+    const std::streamoff WINDOW_SIZE = 65536;
+    std::vector<char> aBuffer(WINDOW_SIZE);
+    std::streamoff nWindowEnd(nOffset + 1);
+    std::streamoff nPosition(0);
+
+    while (nWindowEnd > 0)
+    {
+        std::streamoff nWindowOffset(std::max(nWindowEnd - WINDOW_SIZE, static_cast<std::streamoff>(0)));
+
+        m_aStream.clear();
+        m_aStream.seekg(nWindowOffset);
+
+        if (m_aStream.fail() == true)
         {
-            if (pNamePrefix != nullptr)
-            {
-                throw new std::runtime_error("There can't be two prefixes in element name.");
-            }
+            throw new std::runtime_error("Stream operation failed.");
+        }
 
-            pNamePrefix = std::move(pNameLocalPart);
-            pNameLocalPart.reset(new std::string());
+        m_aStream.read(aBuffer.data(), nWindowEnd - nWindowOffset);
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
         }
-        else if (cByte == '>')
+
+        std::streamoff nCount(m_aStream.gcount());
+        std::streamoff nFound(-1);
+
+        for (std::streamoff i = nCount; i > 0; i--)
         {
-            if (pNamePrefix == nullptr)
-            {
-                pNamePrefix.reset(new std::string);
-            }
-            else
+            if (aBuffer[i - 1] == '<')
             {
-                // if (pNamePrefix->length() <= 0) can't happen because cFirstByte
-                // would already be a character for the prefix name. The prefix
-                // name was already checked to contain valid characters.
+                nFound = nWindowOffset + (i - 1);
+                break;
             }
+        }
 
-            std::unique_ptr<QName> pName(new QName("", *pNameLocalPart, *pNamePrefix));
-            std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
-            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr));
-            m_aEvents.push(std::move(pEvent));
+        if (nFound >= 0)
+        {
+            nPosition = nFound;
             break;
         }
-        else if (cByte == '/')
-        {
-            m_aStream.get(cByte);
 
-            if (m_aStream.eof() == true)
-            {
-                throw new std::runtime_error("Tag start incomplete.");
-            }
+        nWindowEnd = nWindowOffset;
+    }
 
-            if (m_aStream.bad() == true)
-            {
-                throw new std::runtime_error("Stream is bad.");
-            }
+    if (nPosition > 0)
+    {
+        std::streamoff nWindowOffset(std::max(nPosition - WINDOW_SIZE, static_cast<std::streamoff>(0)));
 
-            if (cByte != '>')
-            {
-                throw new std::runtime_error("Empty start + end tag end without closing '>'.");
-            }
+        m_aStream.clear();
+        m_aStream.seekg(nWindowOffset);
+        m_aStream.read(aBuffer.data(), nPosition - nWindowOffset);
 
-            if (pNamePrefix == nullptr)
-            {
-                pNamePrefix.reset(new std::string);
-            }
-            else
-            {
-                // if (pNamePrefix->length() <= 0) can't happen because cFirstByte
-                // would already be a character for the prefix name. The prefix
-                // name was already checked to contain valid characters.
-            }
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
 
-            std::unique_ptr<QName> pName(new QName("", *pNameLocalPart, *pNamePrefix));
-            std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
-            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr));
-            m_aEvents.push(std::move(pEvent));
+        static const char COMMENT_START[] = "<!--";
+        static const char COMMENT_END[] = "-->";
+        static const char PI_START[] = "<?";
+        static const char PI_END[] = "?>";
 
-            pName = std::unique_ptr<QName>(new QName("", *pNameLocalPart, *pNamePrefix));
-            std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
-            pEvent = std::unique_ptr<XMLEvent>(new XMLEvent(nullptr,
-                                                            std::move(pEndElement),
-                                                            nullptr,
-                                                            nullptr,
-                                                            nullptr));
-            m_aEvents.push(std::move(pEvent));
+        const char* pBegin(aBuffer.data());
+        const char* pEnd(pBegin + m_aStream.gcount());
 
-            break;
+        const char* pCommentStart(std::find_end(pBegin, pEnd, COMMENT_START, COMMENT_START + 4));
+        const char* pCommentEnd(std::find_end(pBegin, pEnd, COMMENT_END, COMMENT_END + 3));
+
+        if (pCommentStart != pEnd &&
+            (pCommentEnd == pEnd ||
+             pCommentEnd < pCommentStart))
+        {
+            nPosition = nWindowOffset + (pCommentStart - pBegin);
+            pEnd = pCommentStart;
         }
-        else if (std::isspace(cByte, m_aLocale) != 0)
+
+        const char* pPIStart(std::find_end(pBegin, pEnd, PI_START, PI_START + 2));
+        const char* pPIEnd(std::find_end(pBegin, pEnd, PI_END, PI_END + 2));
+
+        if (pPIStart != pEnd &&
+            (pPIEnd == pEnd ||
+             pPIEnd < pPIStart))
         {
-            if (pNameLocalPart->length() <= 0)
-            {
-                throw new std::runtime_error("Start tag name begins with whitespace.");
-            }
+            nPosition = nWindowOffset + (pPIStart - pBegin);
+        }
+    }
 
-            while (true)
-            {
-                m_aStream.get(cByte);
+    m_aStream.clear();
+    m_aStream.seekg(nPosition);
 
-                if (m_aStream.eof() == true)
-                {
-                    throw new std::runtime_error("Tag start incomplete.");
-                }
+    if (m_aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
 
-                if (m_aStream.bad() == true)
-                {
-                    throw new std::runtime_error("Stream is bad.");
-                }
+    return nPosition;
+}
 
-                if (cByte == '>')
-                {
-                    break;
-                }
-                else if (std::isspace(cByte, m_aLocale) != 0)
-                {
-                    // Ignore/consume.
-                }
-                else if (cByte == '/')
-                {
-                    m_aStream.unget();
+/**
+ * @brief Captures the current position, so reading can continue from it
+ *     later with reset(). Events lexed but not retrieved yet are copied
+ *     into the bookmark, which is usually none or one of them.
+ */
+XMLEventReader::Bookmark XMLEventReader::mark()
+{
+    ClearHistory();
 
-                    if (m_aStream.bad() == true)
-                    {
-                        throw new std::runtime_error("Stream is bad.");
-                    }
+    if (m_aStream.eof() == true)
+    {
+        m_aStream.clear();
+        m_aStream.seekg(0, std::ios_base::end);
+    }
 
-                    break;
-                }
-                else
-                {
-                    HandleAttributes(cByte, pAttributes);
-                    break;
-                }
-            }
-        }
-        else if (std::isalnum(cByte, m_aLocale) == true ||
-                 cByte == '-' ||
-                 cByte == '_' ||
-                 cByte == '.')
-        {
-            pNameLocalPart->push_back(cByte);
-        }
-        else
-        {
-            int nByte(cByte);
-            std::stringstream aMessage;
-            aMessage << "Character '" << cByte << "' (0x"
-                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") not supported in a start tag name.";
-            throw new std::runtime_error(aMessage.str());
-        }
+    Bookmark aBookmark;
 
-        m_aStream.get(cByte);
+    aBookmark.m_nPosition = m_aStream.tellg();
 
-        if (m_aStream.eof() == true)
-        {
-            throw new std::runtime_error("Tag start incomplete.");
-        }
+    if (aBookmark.m_nPosition < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
 
-        if (m_aStream.bad() == true)
-        {
-            throw new std::runtime_error("Stream is bad.");
-        }
+    aBookmark.m_bHasNextCalled = m_bHasNextCalled;
+    aBookmark.m_bHasPreviousCalled = m_bHasPreviousCalled;
+    aBookmark.m_bEventsAreForwardDirection = m_bEventsAreForwardDirection;
+    aBookmark.m_aOpenElements = m_aOpenElements;
+    aBookmark.m_bOpenElementsKnown = m_bOpenElementsKnown;
+    aBookmark.m_aFilterElements = m_aFilterElements;
+    aBookmark.m_nFilterDepth = m_nFilterDepth;
 
-    } while (true);
+    for (std::size_t i = 0, nCount = m_aEvents.size(); i < nCount; i++)
+    {
+        aBookmark.m_aEvents.push_back(m_aEvents.front()->clone());
 
-    return true;
+        m_aEvents.push(std::move(m_aEvents.front()));
+        m_aEvents.pop();
+    }
+
+    return aBookmark;
 }
 
-bool XMLEventReader::HandleTagEnd()
+/**
+ * @brief Returns to a position captured by mark(), without lexing. The
+ *     bookmark can be used again.
+ */
+void XMLEventReader::reset(const Bookmark& aBookmark)
 {
-    char cByte('\0');
-    m_aStream.get(cByte);
+    ClearHistory();
 
-    if (m_aStream.eof() == true)
+    m_aStream.clear();
+    m_aStream.seekg(aBookmark.m_nPosition);
+
+    if (m_aStream.fail() == true)
     {
-        throw new std::runtime_error("Tag end incomplete.");
+        throw new std::runtime_error("Stream operation failed.");
     }
 
-    if (m_aStream.bad() == true)
+    std::queue<std::unique_ptr<XMLEvent>>().swap(m_aEvents);
+
+    for (std::vector<std::unique_ptr<XMLEvent>>::const_iterator iter = aBookmark.m_aEvents.begin();
+         iter != aBookmark.m_aEvents.end();
+         iter++)
     {
-        throw new std::runtime_error("Stream is bad.");
+        m_aEvents.push((*iter)->clone());
     }
 
-    std::unique_ptr<std::string> pNamePrefix(nullptr);
-    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+    m_bHasNextCalled = aBookmark.m_bHasNextCalled;
+    m_bHasPreviousCalled = aBookmark.m_bHasPreviousCalled;
+    m_bEventsAreForwardDirection = aBookmark.m_bEventsAreForwardDirection;
+    m_aOpenElements = aBookmark.m_aOpenElements;
+    m_bOpenElementsKnown = aBookmark.m_bOpenElementsKnown;
+    m_aFilterElements = aBookmark.m_aFilterElements;
+    m_nFilterDepth = aBookmark.m_nFilterDepth;
+}
 
-    // No validity check for the XML element name is needed
-    // if end tags are compared to start tags and the start
-    // tags were already checked.
+/**
+ * @brief Continues after the end tag of the element whose StartElement was
+ *     retrieved last, without creating events for its content.
+ * @details Jumps from '<' to '<' with std::istream::ignore(), which searches
+ *     the stream buffer with memchr(), and only looks at what follows a '<'
+ *     to track the depth and to step over comments, CDATA sections,
+ *     processing instructions and quoted attribute values. Nothing of the
+ *     skipped content is checked for well-formedness.
+ */
+void XMLEventReader::skipElement()
+{
+    if (m_bHasPreviousCalled == true ||
+        m_bEventsAreForwardDirection != true)
+    {
+        throw new std::logic_error("Attempted XMLEventReader::skipElement() while not reading forward.");
+    }
 
-    do
+    ClearHistory();
+
+    if (m_bTrackElements == true &&
+        m_aOpenElements.empty() != true)
     {
-        if (cByte == ':')
-        {
-            if (pNamePrefix != nullptr)
-            {
-                throw new std::runtime_error("There can't be two prefixes in the element name.");
-            }
+        m_aOpenElements.pop_back();
+    }
 
-            pNamePrefix = std::move(pNameLocalPart);
-            pNameLocalPart.reset(new std::string());
-        }
-        else if (cByte == '>')
-        {
-            if (pNamePrefix == nullptr)
-            {
-                pNamePrefix.reset(new std::string);
-            }
-            else
-            {
-                // if (pNamePrefix->length() <= 0) will result in an empty prefix
-                // of the QName anyway, but the reader could complain as well.
-                // The prefix name was already checked to contain valid characters.
-            }
+    std::size_t nDepth(1);
 
-            std::unique_ptr<QName> pName(new QName("", *pNameLocalPart, *pNamePrefix));
-            std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
-            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                          std::move(pEndElement),
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr));
-            m_aEvents.push(std::move(pEvent));
-            return true;
-        }
-        else if (std::isalnum(cByte, m_aLocale) == true ||
-                 cByte == '-' ||
-                 cByte == '_' ||
-                 cByte == '.')
+    // Events of an empty-element tag or of hasNext() calls.
+    while (m_aEvents.empty() != true &&
+           nDepth > 0)
+    {
+        if (m_aEvents.front()->isStartElement() == true)
         {
-            pNameLocalPart->push_back(cByte);
+            ++nDepth;
         }
-        else
+        else if (m_aEvents.front()->isEndElement() == true)
         {
-            int nByte(cByte);
-            std::stringstream aMessage;
-            aMessage << "Character '" << cByte << "' (0x"
-                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") not supported in an end tag name.";
-            throw new std::runtime_error(aMessage.str());
+            --nDepth;
         }
 
-        m_aStream.get(cByte);
+        m_aEvents.pop();
+    }
 
-        if (m_aStream.eof() == true)
-        {
-            throw new std::runtime_error("End tag incomplete.");
-        }
+    m_bHasNextCalled = false;
 
-        if (m_aStream.bad() == true)
+    if (nDepth > 0)
+    {
+        if (m_nFilterDepth > 0)
         {
-            throw new std::runtime_error("Stream is bad.");
+            --m_nFilterDepth;
         }
 
-    } while (true);
+        SkipContent(nDepth);
+    }
 }
 
-bool XMLEventReader::HandleText(const char& cFirstByte)
+/**
+ * @brief Continues before the start tag of the element whose EndElement was
+ *     retrieved last with previousEvent(), without creating events for its
+ *     content.
+ * @details The input is scanned backwards in blocks for '<' and '>', the
+ *     latter only to recognize the ends of comments, processing instructions
+ *     and CDATA sections, which are stepped over as a whole. As "-->", "?>"
+ *     and "]]>" may as well occur in text or attribute values, such an end
+ *     only counts if it's the first one after the nearest "<!--", "<?" or
+ *     "<![CDATA[" before it. '<' can't be part of text or attribute values,
+ *     so every other '<' is a tag, whose end is looked up forward for
+ *     empty-element tags. Not recognized is a "<!--", "<?" or "<![CDATA["
+ *     that's itself within another comment, processing instruction or
+ *     CDATA section, followed later by one of these ends in text or an
+ *     attribute value without a real one in between.
+ */
+void XMLEventReader::skipPreviousElement()
 {
-    std::unique_ptr<std::string> pData(new std::string);
+    if (m_bHasNextCalled == true ||
+        m_bEventsAreForwardDirection == true)
+    {
+        throw new std::logic_error("Attempted XMLEventReader::skipPreviousElement() while not reading backward.");
+    }
 
-    if (cFirstByte == '&')
+    ClearHistory();
+
+    m_bOpenElementsKnown = false;
+
+    std::size_t nDepth(1);
+
+    // Events of an empty-element tag or of hasPrevious() calls.
+    while (m_aEvents.empty() != true &&
+           nDepth > 0)
     {
-        std::unique_ptr<std::string> pResolvedText(nullptr);
+        if (m_aEvents.front()->isEndElement() == true)
+        {
+            ++nDepth;
+        }
+        else if (m_aEvents.front()->isStartElement() == true)
+        {
+            --nDepth;
+        }
 
-        ResolveEntity(pResolvedText);
-        pData->append(*pResolvedText);
+        m_aEvents.pop();
     }
-    else
+
+    m_bHasPreviousCalled = false;
+
+    if (m_aStream.eof() == true)
     {
-        pData->push_back(cFirstByte);
+        m_aStream.clear();
+        m_aStream.seekg(0, std::ios_base::end);
     }
 
-    char cByte('\0');
+    std::streamoff nPosition(m_aStream.tellg());
 
-    while (true)
+    if (nPosition < 0)
     {
-        m_aStream.get(cByte);
+        throw new std::runtime_error("Stream operation failed.");
+    }
 
-        if (m_aStream.eof() == true)
-        {
-            break;
-        }
+    std::vector<char> aBuffer;
+    std::streamoff nBufferOffset(0);
 
-        if (m_aStream.bad() == true)
+    while (nDepth > 0)
+    {
+        if (nPosition <= 0)
         {
-            throw new std::runtime_error("Stream is bad.");
+            throw new std::runtime_error("Element incomplete.");
         }
 
-        if (cByte == '<')
+        --nPosition;
+
+        char cByte(RScanByte(aBuffer, nBufferOffset, nPosition));
+
+        if (cByte == '>')
         {
-            m_aStream.unget();
+            std::streamoff nStart(-1);
 
-            if (m_aStream.bad() == true)
+            if (nPosition >= 2 &&
+                RScanByte(aBuffer, nBufferOffset, nPosition - 1) == '-' &&
+                RScanByte(aBuffer, nBufferOffset, nPosition - 2) == '-')
             {
-                throw new std::runtime_error("Stream is bad.");
+                nStart = RScanMarkupStart(aBuffer, nBufferOffset, nPosition - 2, "<!--", "-->");
+            }
+            else if (nPosition >= 1 &&
+                     RScanByte(aBuffer, nBufferOffset, nPosition - 1) == '?')
+            {
+                nStart = RScanMarkupStart(aBuffer, nBufferOffset, nPosition - 1, "<?", "?>");
+            }
+            else if (nPosition >= 2 &&
+                     RScanByte(aBuffer, nBufferOffset, nPosition - 1) == ']' &&
+                     RScanByte(aBuffer, nBufferOffset, nPosition - 2) == ']')
+            {
+                nStart = RScanMarkupStart(aBuffer, nBufferOffset, nPosition - 2, "<![CDATA[", "]]>");
             }
 
-            break;
+            // Otherwise, the '>' is part of text or an attribute value.
+            if (nStart >= 0)
+            {
+                nPosition = nStart;
+            }
         }
-        else if (cByte == '&')
+        else if (cByte == '<')
         {
-            std::unique_ptr<std::string> pResolvedText(nullptr);
+            cByte = RScanByte(aBuffer, nBufferOffset, nPosition + 1);
 
-            ResolveEntity(pResolvedText);
-            pData->append(*pResolvedText);
-        }
-        else
-        {
-            pData->push_back(cByte);
+            if (cByte == '/')
+            {
+                ++nDepth;
+            }
+            else if (cByte != '!' &&
+                     cByte != '?')
+            {
+                std::streamoff nTagEnd(nPosition + 1);
+                char cPrevious('\0');
+
+                do
+                {
+                    cPrevious = cByte;
+                    ++nTagEnd;
+                    cByte = RScanByte(aBuffer, nBufferOffset, nTagEnd);
+
+                    if (cByte == '"' ||
+                        cByte == '\'')
+                    {
+                        const char cDelimiter(cByte);
+
+                        do
+                        {
+                            ++nTagEnd;
+                            cByte = RScanByte(aBuffer, nBufferOffset, nTagEnd);
+
+                        } while (cByte != cDelimiter);
+                    }
+
+                } while (cByte != '>');
+
+                if (cPrevious != '/')
+                {
+                    --nDepth;
+                }
+            }
         }
     }
 
-    std::unique_ptr<Characters> pCharacters(new Characters(std::move(pData)));
-    std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                  nullptr,
-                                                  std::move(pCharacters),
-                                                  nullptr,
-                                                  nullptr));
-    m_aEvents.push(std::move(pEvent));
+    m_aStream.clear();
+    m_aStream.seekg(nPosition);
 
-    return true;
+    if (m_aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
 }
 
-bool XMLEventReader::HandleProcessingInstruction()
+/**
+ * @brief Captures the current position, the open elements and the entities,
+ *     so reading can continue from there with resume(), also by another
+ *     reader for the same input.
+ * @details Only possible between tokens while reading forward, with the
+ *     open elements tracked from the start on, see setCheckpointHandler().
+ *     Of the entities, only the ones added with
+ *     addToEntityReplacementDictionary() are captured, so a reader that
+ *     resumes needs the same table passed with setEntityTable().
+ */
+Checkpoint XMLEventReader::checkpoint()
 {
-    std::unique_ptr<std::string> pTarget(nullptr);
+    if (m_bTrackElements != true ||
+        m_bOpenElementsKnown != true)
+    {
+        throw new std::logic_error("Attempted XMLEventReader::checkpoint() without tracking the open elements since the start or XMLEventReader::resume().");
+    }
 
-    HandleProcessingInstructionTarget(pTarget);
+    if (m_aEvents.empty() != true)
+    {
+        throw new std::logic_error("Attempted XMLEventReader::checkpoint() with events pending, which need to be retrieved first.");
+    }
 
-    if (pTarget == nullptr)
+    ClearHistory();
+
+    if (m_aStream.eof() == true)
     {
-        throw new std::runtime_error("Processing instruction without target name.");
+        m_aStream.clear();
+        m_aStream.seekg(0, std::ios_base::end);
     }
 
-    if (pTarget->length() == 3)
+    Checkpoint aCheckpoint;
+
+    aCheckpoint.m_nPosition = m_aStream.tellg();
+
+    if (aCheckpoint.m_nPosition < 0)
     {
-        if ((pTarget->at(0) == 'x' ||
-             pTarget->at(0) == 'X') &&
-            (pTarget->at(1) == 'm' ||
-             pTarget->at(1) == 'M') &&
-            (pTarget->at(2) == 'l' ||
-             pTarget->at(2) == 'L'))
-        {
-            /** @todo This should read the XML declaration instructions instead
-              * of just consuming/ignoring it. */
+        throw new std::runtime_error("Stream operation failed.");
+    }
 
-            char cByte('\0');
-            int nMatchCount = 0;
+    aCheckpoint.m_aElements = m_aOpenElements;
 
-            while (nMatchCount < 2)
-            {
-                m_aStream.get(cByte);
+    aCheckpoint.m_aEntities = m_aAddedEntities;
 
-                if (m_aStream.eof() == true)
-                {
-                    throw new std::runtime_error("XML declaration incomplete.");
-                }
+    return aCheckpoint;
+}
 
-                if (m_aStream.bad() == true)
-                {
-                    throw new std::runtime_error("Stream is bad.");
-                }
+/**
+ * @brief Continues reading forward from a checkpoint, without reading the
+ *     input before it.
+ */
+void XMLEventReader::resume(const Checkpoint& aCheckpoint)
+{
+    ClearHistory();
 
-                if (cByte == '?' &&
-                    nMatchCount <= 0)
-                {
-                    nMatchCount++;
-                }
-                else if (cByte == '>' &&
-                        nMatchCount <= 1)
-                {
-                    return false;
-                }
-            }
+    for (std::map<std::string, std::string>::const_iterator iter = aCheckpoint.m_aEntities.begin();
+         iter != aCheckpoint.m_aEntities.end();
+         iter++)
+    {
+        addToEntityReplacementDictionary(iter->first, iter->second);
+    }
 
-            return false;
-        }
+    m_aStream.clear();
+    m_aStream.seekg(aCheckpoint.m_nPosition);
+
+    if (m_aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
     }
 
-    std::unique_ptr<std::string> pData(new std::string);
-    char cByte('\0');
-    int nMatchCount = 0;
+    std::queue<std::unique_ptr<XMLEvent>>().swap(m_aEvents);
+    m_bHasNextCalled = false;
+    m_bHasPreviousCalled = false;
+    m_bEventsAreForwardDirection = true;
 
-    while (nMatchCount < 2)
+    m_aOpenElements = aCheckpoint.m_aElements;
+    m_bOpenElementsKnown = true;
+    m_bTrackElements = true;
+    m_nCheckpointEvents = 0;
+}
+
+/**
+ * @details The first call copies the table this reader shares with others,
+ *     so it's cheaper to build an EntityTable once and pass it to every
+ *     reader with setEntityTable().
+ */
+int XMLEventReader::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+{
+    ClearHistory();
+
+    if (m_pOwnEntityTable == nullptr)
     {
-        m_aStream.get(cByte);
+        m_pOwnEntityTable = std::make_shared<EntityTable>(*m_pEntityTable);
+        m_pEntityTable = m_pOwnEntityTable;
+    }
 
-        if (m_aStream.eof() == true)
-        {
-            throw new std::runtime_error("Processing instruction data incomplete.");
-        }
+    int nResult(m_pOwnEntityTable->add(strName, strReplacementText));
 
-        if (m_aStream.bad() == true)
-        {
-            throw new std::runtime_error("Stream is bad.");
-        }
+    m_aAddedEntities[strName] = strReplacementText;
 
-        if (cByte == '?' &&
-            nMatchCount <= 0)
-        {
-            nMatchCount++;
-        }
-        else if (cByte == '>' &&
-                 nMatchCount <= 1)
-        {
-            //nMatchCount++;
+    return nResult;
+}
 
-            std::unique_ptr<ProcessingInstruction> pProcessingInstruction(new ProcessingInstruction(std::move(pTarget), std::move(pData)));
-            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          std::move(pProcessingInstruction)));
-            m_aEvents.push(std::move(pEvent));
+void XMLEventReader::setEntityTable(const std::shared_ptr<const EntityTable>& pEntityTable)
+{
+    ClearHistory();
 
-            return true;
-        }
-        else
-        {
-            if (nMatchCount > 0)
-            {
-                pData->push_back('?');
-            }
+    if (pEntityTable == nullptr)
+    {
+        throw new std::invalid_argument("Nullptr passed.");
+    }
 
-            nMatchCount = 0;
+    m_pEntityTable = pEntityTable;
+    m_pOwnEntityTable = nullptr;
+    m_aAddedEntities.clear();
+}
 
-            pData->push_back(cByte);
-        }
+/**
+ * @brief Text nodes that consist of whitespace only, like the indentation
+ *     between tags of pretty-printed input, won't be reported as Characters
+ *     events in both directions. They're dropped by the lexer before any
+ *     allocation is done for them. Same as MASK_WHITESPACE of setEventMask().
+ */
+void XMLEventReader::setSuppressWhitespace(const bool& bSuppress)
+{
+    if (bSuppress == true)
+    {
+        setEventMask(m_nEventMask | MASK_WHITESPACE);
+    }
+    else
+    {
+        setEventMask(m_nEventMask & ~MASK_WHITESPACE);
+    }
+}
+
+/**
+ * @brief Event types that won't be reported in both directions. Masked
+ *     comments and processing instructions are skipped by searching for
+ *     their terminator, without collecting their content or creating events.
+ * @param[in] nMask EventMask values combined bitwise, MASK_NONE to report
+ *     all events, which is the default.
+ */
+void XMLEventReader::setEventMask(const unsigned int& nMask)
+{
+    if ((nMask & ~(MASK_COMMENT | MASK_PROCESSING_INSTRUCTION | MASK_WHITESPACE)) != 0)
+    {
+        throw new std::invalid_argument("Unknown event type in mask.");
     }
 
-    return false;
+    ClearHistory();
+
+    m_nEventMask = nMask;
 }
 
-bool XMLEventReader::HandleProcessingInstructionTarget(std::unique_ptr<std::string>& pTarget)
+/**
+ * @brief Keeps copies of up to about nEvents of the events lexed last,
+ *     together with the input spans they were lexed from, so stepping back
+ *     and forth over them is served from memory instead of lexing the input
+ *     again. The position in the input needs to be queried for every token
+ *     lexed, so it's only worth it if the reading changes direction often.
+ * @param[in] nEvents 0 disables the history, which is the default.
+ */
+void XMLEventReader::setHistorySize(const std::size_t& nEvents)
 {
-    std::unique_ptr<std::string> pName(nullptr);
-    char cByte('\0');
-    int nMatchCount = 0;
+    ClearHistory();
 
-    while (nMatchCount < 2)
+    m_nHistorySize = nEvents;
+}
+
+/**
+ * @brief Tracks the open elements for checkpoint() from now on, so needs to
+ *     be called before reading or after resume().
+ * @param[in] aHandler Called with a checkpoint by hasNext() before lexing
+ *     the next token, once at least nInterval events were retrieved since
+ *     the last one. So all events before the checkpoint were retrieved when
+ *     the handler is called.
+ * @param[in] nInterval 0 for calling checkpoint() only explicitly.
+ */
+void XMLEventReader::setCheckpointHandler(const CheckpointHandler& aHandler, const std::size_t& nInterval)
+{
+    if (nInterval > 0 &&
+        aHandler == nullptr)
     {
-        m_aStream.get(cByte);
+        throw new std::invalid_argument("Nullptr passed.");
+    }
 
-        if (m_aStream.eof() == true)
-        {
-            throw new std::runtime_error("Processing instruction target name incomplete.");
-        }
+    m_aCheckpointHandler = aHandler;
+    m_nCheckpointInterval = nInterval;
+    m_nCheckpointEvents = 0;
+    m_bTrackElements = true;
+}
 
-        if (m_aStream.bad() == true)
-        {
-            throw new std::runtime_error("Stream is bad.");
-        }
+/**
+ * @brief Only delivers the events of elements at one of the paths, like
+ *     "/feed/entry/title", including their start and end tags. Everything
+ *     else is skipped without creating events for it, subtrees that can't
+ *     contain a match by scanning from '<' to '<', see skipElement(). Only
+ *     supports reading forward from the start of the input.
+ * @param[in] aPaths Absolute paths of element names with prefix, if any. No
+ *     paths turn the filter off.
+ */
+void XMLEventReader::setPathFilter(const std::vector<std::string>& aPaths)
+{
+    ClearHistory();
 
-        if (cByte == '?' &&
-            nMatchCount <= 0)
-        {
-            nMatchCount++;
-        }
-        else if (cByte == '>' &&
-                 nMatchCount <= 1)
+    m_aFilterPaths.clear();
+    m_aFilterElements.clear();
+    m_nFilterDepth = 0;
+
+    for (std::vector<std::string>::const_iterator iter = aPaths.begin();
+         iter != aPaths.end();
+         iter++)
+    {
+        if (iter->empty() == true ||
+            iter->at(0) != '/')
         {
-            throw new std::runtime_error("Processing instruction ended before processing instruction target name could be read.");
+            throw new std::invalid_argument("Filter path isn't absolute.");
         }
-        else if (std::isspace(cByte, m_aLocale) != 0)
-        {
-            if (pName == nullptr)
-            {
-                throw new std::runtime_error("Processing instruction without target name.");
-            }
 
-            pTarget = std::move(pName);
+        std::vector<std::string> aPath;
+        std::size_t nBegin(1);
 
-            return true;
-        }
-        else
+        while (nBegin <= iter->length())
         {
-            if (nMatchCount > 0)
+            std::size_t nEnd(iter->find('/', nBegin));
+
+            if (nEnd == std::string::npos)
             {
-                throw new std::runtime_error("Processing instruction target name interrupted by '?'.");
+                nEnd = iter->length();
             }
 
-            if (pName == nullptr)
+            if (nEnd <= nBegin)
             {
-                if (std::isalpha(cByte, m_aLocale) != true)
-                {
-                    int nByte(cByte);
-                    std::stringstream aMessage;
-                    aMessage << "Character '" << cByte << "' (0x"
-                             << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                             << ") not supported as first character of an processing instruction target name.";
-                    throw new std::runtime_error(aMessage.str());
-                }
-
-                pName = std::unique_ptr<std::string>(new std::string);
+                throw new std::invalid_argument("Filter path with empty element name.");
             }
 
-            pName->push_back(cByte);
+            aPath.push_back(iter->substr(nBegin, nEnd - nBegin));
+            nBegin = nEnd + 1;
         }
-    }
 
-    return false;
+        m_aFilterPaths.push_back(aPath);
+    }
 }
 
-bool XMLEventReader::HandleMarkupDeclaration()
+/**
+ * @brief Only creates the attributes with one of the names, the values of
+ *     all others are skipped by scanning for their closing delimiter, so
+ *     entities in them aren't resolved either. Applies to elements that
+ *     don't have their own projection.
+ * @param[in] aAttributes Attribute names with prefix, if any. No names turn
+ *     the projection off.
+ */
+void XMLEventReader::setAttributeProjection(const std::vector<std::string>& aAttributes)
 {
-    char cByte('\0');
-    m_aStream.get(cByte);
+    ClearHistory();
 
-    if (m_aStream.eof() == true)
-    {
-        throw new std::runtime_error("Markup declaration incomplete.");
-    }
+    m_aAttributeProjection.clear();
+    m_aAttributeProjection.insert(aAttributes.begin(), aAttributes.end());
+}
 
-    if (m_aStream.bad() == true)
+/**
+ * @brief Like setAttributeProjection(const std::vector<std::string>&), but
+ *     only for elements of the name, overriding the projection for all
+ *     other elements.
+ * @param[in] strElementName Element name with prefix, if any.
+ * @param[in] aAttributes No names turn the projection for the element off,
+ *     so the one for all other elements applies again.
+ */
+void XMLEventReader::setAttributeProjection(const std::string& strElementName, const std::vector<std::string>& aAttributes)
+{
+    if (strElementName.empty() == true)
     {
-        throw new std::runtime_error("Steam is bad.");
+        throw new std::invalid_argument("Empty element name passed.");
     }
 
-    if (cByte == '-')
-    {
-        return HandleComment();
-    }
-    else
+    ClearHistory();
+
+    if (aAttributes.empty() == true)
     {
-        throw new std::runtime_error("Markup declaration type not implemented yet.");
+        m_aElementAttributeProjections.erase(strElementName);
+        return;
     }
 
-    return true;
+    std::set<std::string>& aProjection(m_aElementAttributeProjections[strElementName]);
+
+    aProjection.clear();
+    aProjection.insert(aAttributes.begin(), aAttributes.end());
 }
 
-bool XMLEventReader::HandleComment()
+/**
+ * @brief hasNext() outside of the elements matching the path filter, which
+ *     skips text, comments, processing instructions and end tags until a
+ *     start tag is delivered.
+ * @param[in] cByte First byte of the next token.
+ */
+bool XMLEventReader::FilterNext(char cByte)
 {
-    char cByte('\0');
-    m_aStream.get(cByte);
-
-    if (m_aStream.eof() == true)
-    {
-        throw new std::runtime_error("Comment incomplete.");
-    }
-
-    if (m_aStream.bad() == true)
-    {
-        throw new std::runtime_error("Stream is bad.");
-    }
+    const std::streamsize nMax(std::numeric_limits<std::streamsize>::max());
 
-    if (cByte != '-')
+    while (true)
     {
-        throw new std::runtime_error("Comment malformed.");
-    }
-
-    std::unique_ptr<std::string> pData(new std::string);
+        if (cByte != '<')
+        {
+            m_aStream.ignore(nMax, '<');
 
-    unsigned int nMatchCount = 0;
-    const unsigned int END_SEQUENCE_LENGTH = 3;
-    char cEndSequence[END_SEQUENCE_LENGTH] = { '-', '-', '>' };
+            if (m_aStream.eof() == true)
+            {
+                return false;
+            }
+        }
 
-    do
-    {
         m_aStream.get(cByte);
 
         if (m_aStream.eof() == true)
         {
-            throw new std::runtime_error("Comment incomplete.");
+            throw new std::runtime_error("Tag incomplete.");
         }
 
-        if (m_aStream.bad() == true)
+        if (cByte == '/')
         {
-            throw new std::runtime_error("Stream is bad.");
-        }
+            m_aStream.ignore(nMax, '>');
 
-        if (cByte == cEndSequence[nMatchCount])
-        {
-            if (nMatchCount + 1 < END_SEQUENCE_LENGTH)
+            if (m_aStream.eof() == true)
             {
-                ++nMatchCount;
+                throw new std::runtime_error("Tag end incomplete.");
             }
-            else
-            {
-                std::unique_ptr<Comment> pComment(new Comment(std::move(pData)));
-                std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                              nullptr,
-                                                              nullptr,
-                                                              std::move(pComment),
-                                                              nullptr));
-                m_aEvents.push(std::move(pEvent));
 
-                break;
+            if (m_aFilterElements.empty() != true)
+            {
+                m_aFilterElements.pop_back();
             }
         }
-        else
+        else if (cByte == '!')
         {
-            if (nMatchCount > 0)
-            {
-                // Instead of strncpy() and C-style char*.
-                for (unsigned int i = 0; i < nMatchCount; i++)
-                {
-                    pData->push_back(cEndSequence[i]);
-                }
+            m_aStream.get(cByte);
 
-                pData->push_back(cByte);
-                nMatchCount = 0;
+            if (cByte == '-')
+            {
+                SkipPast("-->");
+            }
+            else if (cByte == '[')
+            {
+                SkipPast("]]>");
             }
             else
             {
-                pData->push_back(cByte);
+                m_aStream.ignore(nMax, '>');
             }
         }
+        else if (cByte == '?')
+        {
+            SkipPast("?>");
+        }
+        else
+        {
+            HandleTagStart(cByte);
 
-    } while (true);
-
-    return true;
-}
-
-bool XMLEventReader::HandleAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes)
-{
-    if (pAttributes == nullptr)
-    {
-        throw new std::invalid_argument("nullptr passed.");
-    }
-
-    std::unique_ptr<QName> pAttributeName(nullptr);
-    std::unique_ptr<std::string> pAttributeValue(nullptr);
-
-    HandleAttributeName(cFirstByte, pAttributeName);
-    HandleAttributeValue(pAttributeValue);
-
-    pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+            if (m_aEvents.empty() != true)
+            {
+                return true;
+            }
+        }
 
-    char cByte('\0');
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
 
-    do
-    {
         m_aStream.get(cByte);
 
         if (m_aStream.eof() == true)
         {
-            throw new std::runtime_error("Tag start incomplete.");
+            return false;
         }
 
         if (m_aStream.bad() == true)
         {
             throw new std::runtime_error("Stream is bad.");
         }
+    }
+}
 
-        if (cByte == '>')
+/**
+ * @brief Decides about a start tag outside of the matches by its name.
+ */
+XMLEventReader::FilterResult XMLEventReader::FilterStartTag(const std::string& strNamePrefix, const std::string& strNameLocalPart)
+{
+    const std::size_t nDepth(m_aFilterElements.size());
+    FilterResult eResult(FILTER_SKIP);
+
+    for (std::vector<std::vector<std::string>>::const_iterator iter = m_aFilterPaths.begin();
+         iter != m_aFilterPaths.end();
+         iter++)
+    {
+        if (iter->size() <= nDepth)
         {
-            // Not part of the attributes any more and indicator for outer
-            // methods to complete the StartElement.
-            m_aStream.unget();
-            break;
+            continue;
         }
-        else if (cByte == '/')
-        {
-            m_aStream.get(cByte);
-
-            if (m_aStream.eof() == true)
-            {
-                throw new std::runtime_error("Tag start incomplete.");
-            }
-
-            if (m_aStream.bad() == true)
-            {
-                throw new std::runtime_error("Stream is bad.");
-            }
-
-            if (cByte != '>')
-            {
-                throw new std::runtime_error("Empty start + end tag end without closing '>'.");
-            }
 
-            m_aStream.unget();
+        const std::string& strStep(iter->at(nDepth));
 
-            if (m_aStream.bad() == true)
+        if (strNamePrefix.empty() == true)
+        {
+            if (strStep != strNameLocalPart)
             {
-                throw new std::runtime_error("Stream is bad.");
+                continue;
             }
-
-            m_aStream.unget();
-
-            if (m_aStream.bad() == true)
+        }
+        else
+        {
+            if (strStep.length() != strNamePrefix.length() + 1 + strNameLocalPart.length() ||
+                strStep.compare(0, strNamePrefix.length(), strNamePrefix) != 0 ||
+                strStep[strNamePrefix.length()] != ':' ||
+                strStep.compare(strNamePrefix.length() + 1, std::string::npos, strNameLocalPart) != 0)
             {
-                throw new std::runtime_error("Stream is bad.");
+                continue;
             }
-
-            break;
         }
-        else if (std::isspace(cByte, m_aLocale) != 0)
+
+        if (std::equal(m_aFilterElements.begin(), m_aFilterElements.end(), iter->begin()) != true)
         {
-            // Ignore/consume.
             continue;
         }
-        else
-        {
-            HandleAttributeName(cByte, pAttributeName);
-            HandleAttributeValue(pAttributeValue);
 
-            pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+        if (iter->size() == nDepth + 1)
+        {
+            return FILTER_DELIVER;
         }
 
-    } while (true);
+        eResult = FILTER_DESCEND;
+    }
 
-    return true;
+    return eResult;
 }
 
-bool XMLEventReader::HandleAttributeName(const char& cFirstByte, std::unique_ptr<QName>& pName)
+/**
+ * @brief Drops a start tag that's not delivered, after it was read
+ *     completely.
+ */
+void XMLEventReader::FilterDrop(const FilterResult& eResult, const std::string& strNamePrefix, const std::string& strNameLocalPart, const bool& bEmpty)
 {
-    std::unique_ptr<std::string> pNamePrefix(nullptr);
-    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+    if (bEmpty == true)
+    {
+        return;
+    }
 
-    if (std::isalnum(cFirstByte, m_aLocale) == true ||
-        cFirstByte == '_')
+    if (eResult == FILTER_DESCEND)
     {
-        pNameLocalPart->push_back(cFirstByte);
+        if (strNamePrefix.empty() == true)
+        {
+            m_aFilterElements.push_back(strNameLocalPart);
+        }
+        else
+        {
+            m_aFilterElements.push_back(strNamePrefix + ":" + strNameLocalPart);
+        }
     }
     else
     {
-        int nByte(cFirstByte);
-        std::stringstream aMessage;
-        aMessage << "Character '" << cFirstByte << "' (0x"
-                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                 << ") not supported as first character of an attribute name.";
-        throw new std::runtime_error(aMessage.str());
+        SkipContent(1);
     }
+}
 
-    char cByte('\0');
-
-    do
+/**
+ * @retval nullptr if all attributes of the element are to be created.
+ */
+const std::set<std::string>* XMLEventReader::FindAttributeProjection(const std::string& strNamePrefix, const std::string& strNameLocalPart)
+{
+    if (m_aElementAttributeProjections.empty() != true)
     {
-        m_aStream.get(cByte);
+        std::map<std::string, std::set<std::string>>::const_iterator iter;
 
-        if (m_aStream.eof() == true)
+        if (strNamePrefix.empty() == true)
         {
-            throw new std::runtime_error("Attribute name incomplete.");
+            iter = m_aElementAttributeProjections.find(strNameLocalPart);
         }
-
-        if (m_aStream.bad() == true)
+        else
         {
-            throw new std::runtime_error("Stream is bad.");
+            iter = m_aElementAttributeProjections.find(strNamePrefix + ":" + strNameLocalPart);
         }
 
-        if (cByte == ':')
+        if (iter != m_aElementAttributeProjections.end())
         {
-            if (pNamePrefix != nullptr)
-            {
-                throw new std::runtime_error("There can't be two prefixes in attribute name.");
-            }
-
-            pNamePrefix = std::move(pNameLocalPart);
-            pNameLocalPart.reset(new std::string());
+            return &(iter->second);
         }
-        else if (std::isspace(cByte, m_aLocale) != 0)
-        {
-            cByte = ConsumeWhitespace();
+    }
 
-            if (cByte == '\0')
-            {
-                throw new std::runtime_error("Attribute incomplete.");
-            }
-            else if (cByte != '=')
-            {
-                throw new std::runtime_error("Attribute name is malformed.");
-            }
+    if (m_aAttributeProjection.empty() != true)
+    {
+        return &m_aAttributeProjection;
+    }
 
-            // To make sure that the next loop iteration will end up in cByte == '='.
-            m_aStream.unget();
+    return nullptr;
+}
 
-            if (m_aStream.bad() == true)
-            {
-                throw new std::runtime_error("Stream is bad.");
-            }
-        }
-        else if (cByte == '=')
-        {
-            if (pNamePrefix == nullptr)
-            {
-                pNamePrefix.reset(new std::string);
-            }
-            else
-            {
-                // if (pNamePrefix->length() <= 0) can't happen because cFirstByte
-                // would already be a character for the prefix name. The prefix
-                // name was already checked to contain valid characters.
-            }
+/**
+ * @brief For reading backward, where the attributes are lexed before the
+ *     element name is known, so they can only be removed afterwards.
+ */
+void XMLEventReader::ProjectAttributes(const QName& aName, std::list<std::unique_ptr<Attribute>>& aAttributes)
+{
+    const std::set<std::string>* pProjection(FindAttributeProjection(aName.getPrefix(), aName.getLocalPart()));
 
-            pName = std::unique_ptr<QName>(new QName("", *pNameLocalPart, *pNamePrefix));
+    if (pProjection == nullptr)
+    {
+        return;
+    }
 
-            return true;
+    std::list<std::unique_ptr<Attribute>>::iterator iter = aAttributes.begin();
+
+    while (iter != aAttributes.end())
+    {
+        const QName& aAttributeName((*iter)->getName());
+
+        m_strAttributeName.clear();
+
+        if (aAttributeName.getPrefix().empty() != true)
+        {
+            m_strAttributeName.append(aAttributeName.getPrefix());
+            m_strAttributeName.push_back(':');
         }
-        else if (std::isalnum(cByte, m_aLocale) == true ||
-                 cByte == '-' ||
-                 cByte == '_' ||
-                 cByte == '.')
+
+        m_strAttributeName.append(aAttributeName.getLocalPart());
+
+        if (pProjection->find(m_strAttributeName) == pProjection->end())
         {
-            pNameLocalPart->push_back(cByte);
+            iter = aAttributes.erase(iter);
         }
         else
         {
-            int nByte(cByte);
-            std::stringstream aMessage;
-            aMessage << "Character '" << cByte << "' (0x"
-                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") not supported in an attribute name.";
-            throw new std::runtime_error(aMessage.str());
+            iter++;
         }
-
-    } while (true);
-
-    return false;
+    }
 }
 
-bool XMLEventReader::HandleAttributeValue(std::unique_ptr<std::string>& pValue)
+/**
+ * @brief Lexes the next token.
+ * @retval false at the end of the input, or with m_bHasNextCalled reset to
+ *     false if the token was skipped without events, like a masked comment.
+ */
+bool XMLEventReader::HandleToken()
 {
-    pValue = std::unique_ptr<std::string>(new std::string);
-    char cDelimiter(ConsumeWhitespace());
+    char cByte('\0');
+    m_aStream.get(cByte);
 
-    if (cDelimiter == '\0')
+    if (m_aStream.eof() == true)
     {
-        throw new std::runtime_error("Attribute is missing its value.");
+        return false;
     }
-    else if (cDelimiter != '\'' &&
-             cDelimiter != '"')
+
+    if (m_aStream.bad() == true)
     {
-        int nByte(cDelimiter);
-        std::stringstream aMessage;
-        aMessage << "Attribute value doesn't start with a delimiter like ''' or '\"', instead, '" << cDelimiter << "' (0x"
-                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                 << ") was found.";
-        throw new std::runtime_error(aMessage.str());
+        throw new std::runtime_error("Stream is bad.");
+    }
+
+    if (m_aFilterPaths.empty() != true &&
+        m_nFilterDepth <= 0)
+    {
+        return FilterNext(cByte);
+    }
+
+    if (cByte == '<')
+    {
+        return HandleTag();
+    }
+    else
+    {
+        return HandleText(cByte);
     }
+}
 
+bool XMLEventReader::HandleTag()
+{
     char cByte('\0');
+    m_aStream.get(cByte);
 
-    do
+    if (m_aStream.eof() == true)
     {
-        m_aStream.get(cByte);
+        throw new std::runtime_error("Tag incomplete.");
+    }
 
-        if (m_aStream.eof() == true)
-        {
-            throw new std::runtime_error("Attribute value incomplete.");
-        }
+    if (m_aStream.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
 
-        if (m_aStream.bad() == true)
+    if (cByte == '?')
+    {
+        if ((m_nEventMask & MASK_PROCESSING_INSTRUCTION) != 0)
         {
-            throw new std::runtime_error("Stream is bad.");
+            SkipPast("?>");
+
+            m_bHasNextCalled = false;
+            return false;
         }
 
-        if (cByte == cDelimiter)
+        if (HandleProcessingInstruction() == true)
         {
             return true;
         }
-        else if (cByte == '&')
-        {
-            std::unique_ptr<std::string> pResolvedText(nullptr);
-
-            ResolveEntity(pResolvedText);
-            pValue->append(*pResolvedText);
-        }
         else
         {
-            pValue->push_back(cByte);
+            m_bHasNextCalled = false;
+            return false;
         }
-
-    } while (true);
-
-    return false;
-}
-
-/**
- * @todo This may or may not be adjusted to become a little more like
- *     XMLEventReader::ResolveREntity(), so that no special handling of
- *     the first m_aStream.get() is needed outside of the loop.
- */
-void XMLEventReader::ResolveEntity(std::unique_ptr<std::string>& pResolvedText)
-{
-    if (pResolvedText != nullptr)
+    }
+    else if (cByte == '/')
+    {
+        return HandleTagEnd();
+    }
+    else if (cByte == '!')
+    {
+        return HandleMarkupDeclaration();
+    }
+    else if (std::isalpha(cByte, m_aLocale) == true ||
+             cByte == '_')
     {
-        throw new std::invalid_argument("No nullptr passed.");
+        return HandleTagStart(cByte);
+    }
+    else
+    {
+        int nByte(cByte);
+        std::stringstream aMessage;
+        aMessage << "Unknown byte '" << cByte << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") within element.";
+        throw new std::runtime_error(aMessage.str());
     }
+}
 
+bool XMLEventReader::HandleTagStart(const char& cFirstByte)
+{
     char cByte('\0');
     m_aStream.get(cByte);
 
     if (m_aStream.eof() == true)
     {
-        throw new std::runtime_error("Entity incomplete.");
+        throw new std::runtime_error("Tag start incomplete.");
     }
 
     if (m_aStream.bad() == true)
@@ -1204,22 +1559,74 @@ void XMLEventReader::ResolveEntity(std::unique_ptr<std::string>& pResolvedText)
         throw new std::runtime_error("Stream is bad.");
     }
 
-    if (cByte == ';')
-    {
-        throw new std::runtime_error("Entity has no name.");
-    }
-    else
+    std::unique_ptr<std::string> pNamePrefix(nullptr);
+    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+    std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
+
+    pNameLocalPart->push_back(cFirstByte);
+
+    do
     {
-        std::unique_ptr<std::string> pEntityName(new std::string);
-        pEntityName->push_back(cByte);
+        if (cByte == ':')
+        {
+            if (pNamePrefix != nullptr)
+            {
+                throw new std::runtime_error("There can't be two prefixes in element name.");
+            }
 
-        do
+            pNamePrefix = std::move(pNameLocalPart);
+            pNameLocalPart.reset(new std::string());
+        }
+        else if (cByte == '>')
+        {
+            if (pNamePrefix == nullptr)
+            {
+                pNamePrefix.reset(new std::string);
+            }
+            else
+            {
+                // if (pNamePrefix->length() <= 0) can't happen because cFirstByte
+                // would already be a character for the prefix name. The prefix
+                // name was already checked to contain valid characters.
+            }
+
+            if (m_aFilterPaths.empty() != true)
+            {
+                if (m_nFilterDepth > 0)
+                {
+                    ++m_nFilterDepth;
+                }
+                else
+                {
+                    FilterResult eResult(FilterStartTag(*pNamePrefix, *pNameLocalPart));
+
+                    if (eResult != FILTER_DELIVER)
+                    {
+                        FilterDrop(eResult, *pNamePrefix, *pNameLocalPart, false);
+                        return false;
+                    }
+
+                    m_nFilterDepth = 1;
+                }
+            }
+
+            std::unique_ptr<QName> pName(new QName("", *pNameLocalPart, *pNamePrefix));
+            std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
+            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr));
+            m_aEvents.push(std::move(pEvent));
+            break;
+        }
+        else if (cByte == '/')
         {
             m_aStream.get(cByte);
 
             if (m_aStream.eof() == true)
             {
-                throw new std::runtime_error("Entity incomplete.");
+                throw new std::runtime_error("Tag start incomplete.");
             }
 
             if (m_aStream.bad() == true)
@@ -1227,145 +1634,201 @@ void XMLEventReader::ResolveEntity(std::unique_ptr<std::string>& pResolvedText)
                 throw new std::runtime_error("Stream is bad.");
             }
 
-            if (cByte == ';')
+            if (cByte != '>')
             {
-                break;
+                throw new std::runtime_error("Empty start + end tag end without closing '>'.");
             }
 
-            pEntityName->push_back(cByte);
-
-        } while (true);
+            if (pNamePrefix == nullptr)
+            {
+                pNamePrefix.reset(new std::string);
+            }
+            else
+            {
+                // if (pNamePrefix->length() <= 0) can't happen because cFirstByte
+                // would already be a character for the prefix name. The prefix
+                // name was already checked to contain valid characters.
+            }
 
-        std::map<std::string, std::string>::iterator iter = m_aEntityReplacementDictionary.find(*pEntityName);
+            if (m_aFilterPaths.empty() != true &&
+                m_nFilterDepth <= 0)
+            {
+                FilterResult eResult(FilterStartTag(*pNamePrefix, *pNameLocalPart));
 
-        if (iter != m_aEntityReplacementDictionary.end())
-        {
-            pResolvedText = std::unique_ptr<std::string>(new std::string(iter->second));
-        }
-        else
-        {
-            std::stringstream aMessage;
-            aMessage << "Unable to resolve entity '&" << *pEntityName << ";'.";
-            throw new std::runtime_error(aMessage.str());
-        }
-    }
-}
+                if (eResult != FILTER_DELIVER)
+                {
+                    FilterDrop(eResult, *pNamePrefix, *pNameLocalPart, true);
+                    return false;
+                }
+            }
 
-/**
- * @retval Returns the first non-whitespace character or '\0' in
- *     case of end-of-file.
- */
-char XMLEventReader::ConsumeWhitespace()
-{
-    char cByte('\0');
+            std::unique_ptr<QName> pName(new QName("", *pNameLocalPart, *pNamePrefix));
+            std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
+            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr));
+            m_aEvents.push(std::move(pEvent));
 
-    do
-    {
-        m_aStream.get(cByte);
+            pName = std::unique_ptr<QName>(new QName("", *pNameLocalPart, *pNamePrefix));
+            std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
+            pEvent = std::unique_ptr<XMLEvent>(new XMLEvent(nullptr,
+                                                            std::move(pEndElement),
+                                                            nullptr,
+                                                            nullptr,
+                                                            nullptr));
+            m_aEvents.push(std::move(pEvent));
 
-        if (m_aStream.eof() == true)
-        {
-            return '\0';
+            break;
         }
-
-        if (m_aStream.bad() == true)
+        else if (std::isspace(cByte, m_aLocale) != 0)
         {
-            throw new std::runtime_error("Stream is bad.");
-        }
+            if (pNameLocalPart->length() <= 0)
+            {
+                throw new std::runtime_error("Start tag name begins with whitespace.");
+            }
 
-        if (std::isspace(cByte, m_aLocale) == 0)
-        {
-            return cByte;
-        }
+            if (m_aFilterPaths.empty() != true &&
+                m_nFilterDepth <= 0)
+            {
+                // Decided before the attributes are lexed, so they're only
+                // lexed for elements that are delivered.
+                const std::string strNamePrefix(pNamePrefix != nullptr ? *pNamePrefix : std::string());
+                FilterResult eResult(FilterStartTag(strNamePrefix, *pNameLocalPart));
 
-    } while (true);
-}
+                if (eResult != FILTER_DELIVER)
+                {
+                    FilterDrop(eResult, strNamePrefix, *pNameLocalPart, SkipTagRest(cByte));
+                    return false;
+                }
+            }
 
-bool XMLEventReader::HandleRTag()
-{
-    char cByte('\0');
+            while (true)
+            {
+                m_aStream.get(cByte);
 
-    if (rget(cByte) != true)
-    {
-        throw new std::runtime_error("Tag incomplete.");
-    }
+                if (m_aStream.eof() == true)
+                {
+                    throw new std::runtime_error("Tag start incomplete.");
+                }
 
-    if (cByte == '?')
-    {
-        if (HandleRProcessingInstruction() == true)
-        {
-            return true;
-        }
-        else
-        {
-            m_bHasPreviousCalled = false;
-            return hasPrevious();
-        }
-    }
-    else if (std::isspace(cByte) != 0)
-    {
-        cByte = ConsumeRWhitespace();
+                if (m_aStream.bad() == true)
+                {
+                    throw new std::runtime_error("Stream is bad.");
+                }
 
-        if (cByte == '\0')
+                if (cByte == '>')
+                {
+                    break;
+                }
+                else if (std::isspace(cByte, m_aLocale) != 0)
+                {
+                    // Ignore/consume.
+                }
+                else if (cByte == '/')
+                {
+                    m_aStream.unget();
+
+                    if (m_aStream.bad() == true)
+                    {
+                        throw new std::runtime_error("Stream is bad.");
+                    }
+
+                    break;
+                }
+                else
+                {
+                    HandleAttributes(cByte,
+                                     pAttributes,
+                                     FindAttributeProjection(pNamePrefix != nullptr ? *pNamePrefix : std::string(),
+                                                             *pNameLocalPart));
+                    break;
+                }
+            }
+        }
+        else if (std::isalnum(cByte, m_aLocale) == true ||
+                 cByte == '-' ||
+                 cByte == '_' ||
+                 cByte == '.')
         {
-            throw new std::runtime_error("Start tag incomplete.");
+            pNameLocalPart->push_back(cByte);
         }
-        else if (cByte != '"' &&
-                 cByte != '\'')
+        else
         {
             int nByte(cByte);
             std::stringstream aMessage;
-            aMessage << "Attribute value in start element doesn't start with a delimiter like ''' or '\"', instead, '"
-                     << cByte << "' (0x"
+            aMessage << "Character '" << cByte << "' (0x"
                      << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") was found.";
+                     << ") not supported in a start tag name.";
             throw new std::runtime_error(aMessage.str());
         }
 
-        std::unique_ptr<StartElement> pStartElement(nullptr);
+        m_aStream.get(cByte);
 
-        if (HandleRTagStart(cByte, pStartElement) == true)
+        if (m_aStream.eof() == true)
         {
-            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr));
-            m_aEvents.push(std::move(pEvent));
-            return true;
+            throw new std::runtime_error("Tag start incomplete.");
         }
-        else
+
+        if (m_aStream.bad() == true)
         {
-            return false;
+            throw new std::runtime_error("Stream is bad.");
         }
+
+    } while (true);
+
+    return true;
+}
+
+bool XMLEventReader::HandleTagEnd()
+{
+    char cByte('\0');
+    m_aStream.get(cByte);
+
+    if (m_aStream.eof() == true)
+    {
+        throw new std::runtime_error("Tag end incomplete.");
     }
-    else if (cByte == '/')
+
+    if (m_aStream.bad() == true)
     {
-        cByte = ConsumeRWhitespace();
+        throw new std::runtime_error("Stream is bad.");
+    }
 
-        if (cByte == '\0')
+    std::unique_ptr<std::string> pNamePrefix(nullptr);
+    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+
+    // No validity check for the XML element name is needed
+    // if end tags are compared to start tags and the start
+    // tags were already checked.
+
+    do
+    {
+        if (cByte == ':')
         {
-            throw new std::runtime_error("Start tag incomplete.");
+            if (pNamePrefix != nullptr)
+            {
+                throw new std::runtime_error("There can't be two prefixes in the element name.");
+            }
+
+            pNamePrefix = std::move(pNameLocalPart);
+            pNameLocalPart.reset(new std::string());
         }
-        else if (cByte != '"' &&
-                 cByte != '\'')
+        else if (cByte == '>')
         {
-            int nByte(cByte);
-            std::stringstream aMessage;
-            aMessage << "Attribute value doesn't start with a delimiter like ''' or '\"', instead, '"
-                     << cByte << "' (0x"
-                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") was found.";
-            throw new std::runtime_error(aMessage.str());
-        }
-
-        std::unique_ptr<StartElement> pStartElement(nullptr);
+            if (pNamePrefix == nullptr)
+            {
+                pNamePrefix.reset(new std::string);
+            }
+            else
+            {
+                // if (pNamePrefix->length() <= 0) will result in an empty prefix
+                // of the QName anyway, but the reader could complain as well.
+                // The prefix name was already checked to contain valid characters.
+            }
 
-        if (HandleRTagStart(cByte, pStartElement) == true)
-        {
-            std::unique_ptr<QName> pName(new QName(pStartElement->getName().getNamespaceURI(),
-                                                   pStartElement->getName().getLocalPart(),
-                                                   pStartElement->getName().getPrefix()));
+            std::unique_ptr<QName> pName(new QName("", *pNameLocalPart, *pNamePrefix));
             std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
             std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
                                                           std::move(pEndElement),
@@ -1374,198 +1837,1979 @@ bool XMLEventReader::HandleRTag()
                                                           nullptr));
             m_aEvents.push(std::move(pEvent));
 
-            pEvent.reset(new XMLEvent(std::move(pStartElement),
-                                      nullptr,
-                                      nullptr,
-                                      nullptr,
-                                      nullptr));
-            m_aEvents.push(std::move(pEvent));
+            if (m_nFilterDepth > 0)
+            {
+                --m_nFilterDepth;
+            }
 
             return true;
         }
+        else if (std::isalnum(cByte, m_aLocale) == true ||
+                 cByte == '-' ||
+                 cByte == '_' ||
+                 cByte == '.')
+        {
+            pNameLocalPart->push_back(cByte);
+        }
         else
         {
-            return false;
+            int nByte(cByte);
+            std::stringstream aMessage;
+            aMessage << "Character '" << cByte << "' (0x"
+                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                     << ") not supported in an end tag name.";
+            throw new std::runtime_error(aMessage.str());
         }
-    }
-    else if (cByte == '"' ||
-             cByte == '\'')
-    {
-        std::unique_ptr<StartElement> pStartElement(nullptr);
 
-        if (HandleRTagStart(cByte, pStartElement) == true)
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
         {
-            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr,
-                                                          nullptr));
-            m_aEvents.push(std::move(pEvent));
-            return true;
+            throw new std::runtime_error("End tag incomplete.");
         }
-        else
+
+        if (m_aStream.bad() == true)
         {
-            return false;
+            throw new std::runtime_error("Stream is bad.");
         }
-    }
-    else if (cByte == '-')
+
+    } while (true);
+}
+
+bool XMLEventReader::HandleText(const char& cFirstByte)
+{
+    std::unique_ptr<std::string> pData(nullptr);
+    char cByte(cFirstByte);
+
+    if ((m_nEventMask & MASK_WHITESPACE) != 0 &&
+        std::isspace(cFirstByte, m_aLocale) != 0)
     {
-        if (rget(cByte) != true)
-        {
-            throw new std::runtime_error("Tag incomplete.");
-        }
+        m_strWhitespace.assign(1, cFirstByte);
 
-        if (cByte == '-')
+        while (true)
         {
-            return HandleRComment();
+            m_aStream.get(cByte);
+
+            if (m_aStream.eof() == true)
+            {
+                m_bHasNextCalled = false;
+                return false;
+            }
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+
+            if (std::isspace(cByte, m_aLocale) == 0)
+            {
+                break;
+            }
+
+            m_strWhitespace.push_back(cByte);
         }
-        else
+
+        if (cByte == '<')
         {
-            runget();
-            return HandleRTagStartEnd('-');
+            m_aStream.unget();
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+
+            m_bHasNextCalled = false;
+            return false;
         }
+
+        // Not whitespace only, so the text starts with it.
+        pData.reset(new std::string(m_strWhitespace));
     }
     else
     {
-        return HandleRTagStartEnd(cByte);
+        pData.reset(new std::string);
     }
-}
-
-bool XMLEventReader::HandleRTagStartEnd(const char& cFirstByte)
-{
-    std::unique_ptr<QName> pName(nullptr);
 
-    if (HandleRTagName(cFirstByte, pName) != true)
+    if (cByte == '&')
     {
-        throw new std::runtime_error("Tag name incomplete.");
+        ResolveEntity(*pData);
     }
-
-    char cByte('\0');
-
-    if (rget(cByte) != true)
+    else
     {
-        throw new std::runtime_error("Tag incomplete.");
+        pData->push_back(cByte);
     }
 
-    if (cByte == '<')
+    while (true)
     {
-        std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
-        std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
-        std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
-                                                      nullptr,
-                                                      nullptr,
-                                                      nullptr,
-                                                      nullptr));
-        m_aEvents.push(std::move(pEvent));
-        return true;
-    }
-    else if (cByte == '/')
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            break;
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == '<')
+        {
+            m_aStream.unget();
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+
+            break;
+        }
+        else if (cByte == '&')
+        {
+            ResolveEntity(*pData);
+        }
+        else
+        {
+            pData->push_back(cByte);
+        }
+    }
+
+    std::unique_ptr<Characters> pCharacters(new Characters(std::move(pData)));
+    std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                  nullptr,
+                                                  std::move(pCharacters),
+                                                  nullptr,
+                                                  nullptr));
+    m_aEvents.push(std::move(pEvent));
+
+    return true;
+}
+
+bool XMLEventReader::HandleProcessingInstruction()
+{
+    std::unique_ptr<std::string> pTarget(nullptr);
+
+    HandleProcessingInstructionTarget(pTarget);
+
+    if (pTarget == nullptr)
+    {
+        throw new std::runtime_error("Processing instruction without target name.");
+    }
+
+    if (pTarget->length() == 3)
+    {
+        if ((pTarget->at(0) == 'x' ||
+             pTarget->at(0) == 'X') &&
+            (pTarget->at(1) == 'm' ||
+             pTarget->at(1) == 'M') &&
+            (pTarget->at(2) == 'l' ||
+             pTarget->at(2) == 'L'))
+        {
+            /** @todo This should read the XML declaration instructions instead
+              * of just consuming/ignoring it. */
+
+            char cByte('\0');
+            int nMatchCount = 0;
+
+            while (nMatchCount < 2)
+            {
+                m_aStream.get(cByte);
+
+                if (m_aStream.eof() == true)
+                {
+                    throw new std::runtime_error("XML declaration incomplete.");
+                }
+
+                if (m_aStream.bad() == true)
+                {
+                    throw new std::runtime_error("Stream is bad.");
+                }
+
+                if (cByte == '?' &&
+                    nMatchCount <= 0)
+                {
+                    nMatchCount++;
+                }
+                else if (cByte == '>' &&
+                        nMatchCount <= 1)
+                {
+                    return false;
+                }
+            }
+
+            return false;
+        }
+    }
+
+    std::unique_ptr<std::string> pData(new std::string);
+    char cByte('\0');
+    int nMatchCount = 0;
+
+    while (nMatchCount < 2)
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Processing instruction data incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == '?' &&
+            nMatchCount <= 0)
+        {
+            nMatchCount++;
+        }
+        else if (cByte == '>' &&
+                 nMatchCount <= 1)
+        {
+            //nMatchCount++;
+
+            std::unique_ptr<ProcessingInstruction> pProcessingInstruction(new ProcessingInstruction(std::move(pTarget), std::move(pData)));
+            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr,
+                                                          std::move(pProcessingInstruction)));
+            m_aEvents.push(std::move(pEvent));
+
+            return true;
+        }
+        else
+        {
+            if (nMatchCount > 0)
+            {
+                pData->push_back('?');
+            }
+
+            nMatchCount = 0;
+
+            pData->push_back(cByte);
+        }
+    }
+
+    return false;
+}
+
+bool XMLEventReader::HandleProcessingInstructionTarget(std::unique_ptr<std::string>& pTarget)
+{
+    std::unique_ptr<std::string> pName(nullptr);
+    char cByte('\0');
+    int nMatchCount = 0;
+
+    while (nMatchCount < 2)
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Processing instruction target name incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == '?' &&
+            nMatchCount <= 0)
+        {
+            nMatchCount++;
+        }
+        else if (cByte == '>' &&
+                 nMatchCount <= 1)
+        {
+            throw new std::runtime_error("Processing instruction ended before processing instruction target name could be read.");
+        }
+        else if (std::isspace(cByte, m_aLocale) != 0)
+        {
+            if (pName == nullptr)
+            {
+                throw new std::runtime_error("Processing instruction without target name.");
+            }
+
+            pTarget = std::move(pName);
+
+            return true;
+        }
+        else
+        {
+            if (nMatchCount > 0)
+            {
+                throw new std::runtime_error("Processing instruction target name interrupted by '?'.");
+            }
+
+            if (pName == nullptr)
+            {
+                if (std::isalpha(cByte, m_aLocale) != true)
+                {
+                    int nByte(cByte);
+                    std::stringstream aMessage;
+                    aMessage << "Character '" << cByte << "' (0x"
+                             << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                             << ") not supported as first character of an processing instruction target name.";
+                    throw new std::runtime_error(aMessage.str());
+                }
+
+                pName = std::unique_ptr<std::string>(new std::string);
+            }
+
+            pName->push_back(cByte);
+        }
+    }
+
+    return false;
+}
+
+bool XMLEventReader::HandleMarkupDeclaration()
+{
+    char cByte('\0');
+    m_aStream.get(cByte);
+
+    if (m_aStream.eof() == true)
+    {
+        throw new std::runtime_error("Markup declaration incomplete.");
+    }
+
+    if (m_aStream.bad() == true)
+    {
+        throw new std::runtime_error("Steam is bad.");
+    }
+
+    if (cByte == '-')
+    {
+        return HandleComment();
+    }
+    else
+    {
+        throw new std::runtime_error("Markup declaration type not implemented yet.");
+    }
+
+    return true;
+}
+
+bool XMLEventReader::HandleComment()
+{
+    char cByte('\0');
+    m_aStream.get(cByte);
+
+    if (m_aStream.eof() == true)
+    {
+        throw new std::runtime_error("Comment incomplete.");
+    }
+
+    if (m_aStream.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+
+    if (cByte != '-')
+    {
+        throw new std::runtime_error("Comment malformed.");
+    }
+
+    if ((m_nEventMask & MASK_COMMENT) != 0)
+    {
+        SkipPast("-->");
+
+        m_bHasNextCalled = false;
+        return false;
+    }
+
+    std::unique_ptr<std::string> pData(new std::string);
+
+    unsigned int nMatchCount = 0;
+    const unsigned int END_SEQUENCE_LENGTH = 3;
+    char cEndSequence[END_SEQUENCE_LENGTH] = { '-', '-', '>' };
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Comment incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == cEndSequence[nMatchCount])
+        {
+            if (nMatchCount + 1 < END_SEQUENCE_LENGTH)
+            {
+                ++nMatchCount;
+            }
+            else
+            {
+                std::unique_ptr<Comment> pComment(new Comment(std::move(pData)));
+                std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                              nullptr,
+                                                              nullptr,
+                                                              std::move(pComment),
+                                                              nullptr));
+                m_aEvents.push(std::move(pEvent));
+
+                break;
+            }
+        }
+        else
+        {
+            if (nMatchCount > 0)
+            {
+                // Instead of strncpy() and C-style char*.
+                for (unsigned int i = 0; i < nMatchCount; i++)
+                {
+                    pData->push_back(cEndSequence[i]);
+                }
+
+                pData->push_back(cByte);
+                nMatchCount = 0;
+            }
+            else
+            {
+                pData->push_back(cByte);
+            }
+        }
+
+    } while (true);
+
+    return true;
+}
+
+/**
+ * @param[in] pProjection Names of the attributes to create, nullptr for all,
+ *     see setAttributeProjection().
+ */
+bool XMLEventReader::HandleAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes, const std::set<std::string>* pProjection)
+{
+    if (pAttributes == nullptr)
+    {
+        throw new std::invalid_argument("nullptr passed.");
+    }
+
+    HandleAttribute(cFirstByte, *pAttributes, pProjection);
+
+    char cByte('\0');
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Tag start incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == '>')
+        {
+            // Not part of the attributes any more and indicator for outer
+            // methods to complete the StartElement.
+            m_aStream.unget();
+            break;
+        }
+        else if (cByte == '/')
+        {
+            m_aStream.get(cByte);
+
+            if (m_aStream.eof() == true)
+            {
+                throw new std::runtime_error("Tag start incomplete.");
+            }
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+
+            if (cByte != '>')
+            {
+                throw new std::runtime_error("Empty start + end tag end without closing '>'.");
+            }
+
+            m_aStream.unget();
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+
+            m_aStream.unget();
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+
+            break;
+        }
+        else if (std::isspace(cByte, m_aLocale) != 0)
+        {
+            // Ignore/consume.
+            continue;
+        }
+        else
+        {
+            HandleAttribute(cByte, *pAttributes, pProjection);
+        }
+
+    } while (true);
+
+    return true;
+}
+
+void XMLEventReader::HandleAttribute(const char& cFirstByte, std::list<std::unique_ptr<Attribute>>& aAttributes, const std::set<std::string>* pProjection)
+{
+    std::unique_ptr<QName> pAttributeName(nullptr);
+    std::unique_ptr<std::string> pAttributeValue(nullptr);
+
+    if (pProjection == nullptr)
+    {
+        HandleAttributeName(cFirstByte, pAttributeName);
+        HandleAttributeValue(pAttributeValue);
+
+        aAttributes.push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+
+        return;
+    }
+
+    // The name is only scanned into the buffer, so nothing is allocated for
+    // attributes that aren't projected.
+    ScanAttributeName(cFirstByte, m_strAttributeName);
+
+    if (pProjection->find(m_strAttributeName) == pProjection->end())
+    {
+        SkipAttributeValue();
+        return;
+    }
+
+    std::size_t nColon(m_strAttributeName.find(':'));
+
+    if (nColon == std::string::npos)
+    {
+        pAttributeName.reset(new QName("", m_strAttributeName, ""));
+    }
+    else
+    {
+        pAttributeName.reset(new QName("", m_strAttributeName.substr(nColon + 1), m_strAttributeName.substr(0, nColon)));
+    }
+
+    HandleAttributeValue(pAttributeValue);
+
+    aAttributes.push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+}
+
+bool XMLEventReader::HandleAttributeName(const char& cFirstByte, std::unique_ptr<QName>& pName)
+{
+    std::unique_ptr<std::string> pNamePrefix(nullptr);
+    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+
+    if (std::isalnum(cFirstByte, m_aLocale) == true ||
+        cFirstByte == '_')
+    {
+        pNameLocalPart->push_back(cFirstByte);
+    }
+    else
+    {
+        int nByte(cFirstByte);
+        std::stringstream aMessage;
+        aMessage << "Character '" << cFirstByte << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") not supported as first character of an attribute name.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    char cByte('\0');
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Attribute name incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == ':')
+        {
+            if (pNamePrefix != nullptr)
+            {
+                throw new std::runtime_error("There can't be two prefixes in attribute name.");
+            }
+
+            pNamePrefix = std::move(pNameLocalPart);
+            pNameLocalPart.reset(new std::string());
+        }
+        else if (std::isspace(cByte, m_aLocale) != 0)
+        {
+            cByte = ConsumeWhitespace();
+
+            if (cByte == '\0')
+            {
+                throw new std::runtime_error("Attribute incomplete.");
+            }
+            else if (cByte != '=')
+            {
+                throw new std::runtime_error("Attribute name is malformed.");
+            }
+
+            // To make sure that the next loop iteration will end up in cByte == '='.
+            m_aStream.unget();
+
+            if (m_aStream.bad() == true)
+            {
+                throw new std::runtime_error("Stream is bad.");
+            }
+        }
+        else if (cByte == '=')
+        {
+            if (pNamePrefix == nullptr)
+            {
+                pNamePrefix.reset(new std::string);
+            }
+            else
+            {
+                // if (pNamePrefix->length() <= 0) can't happen because cFirstByte
+                // would already be a character for the prefix name. The prefix
+                // name was already checked to contain valid characters.
+            }
+
+            pName = std::unique_ptr<QName>(new QName("", *pNameLocalPart, *pNamePrefix));
+
+            return true;
+        }
+        else if (std::isalnum(cByte, m_aLocale) == true ||
+                 cByte == '-' ||
+                 cByte == '_' ||
+                 cByte == '.')
+        {
+            pNameLocalPart->push_back(cByte);
+        }
+        else
+        {
+            int nByte(cByte);
+            std::stringstream aMessage;
+            aMessage << "Character '" << cByte << "' (0x"
+                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                     << ") not supported in an attribute name.";
+            throw new std::runtime_error(aMessage.str());
+        }
+
+    } while (true);
+
+    return false;
+}
+
+/**
+ * @brief Like HandleAttributeName(), but only collects the name with prefix,
+ *     if any, in strName, which keeps its capacity.
+ */
+bool XMLEventReader::ScanAttributeName(const char& cFirstByte, std::string& strName)
+{
+    strName.clear();
+
+    if (std::isalnum(cFirstByte, m_aLocale) == true ||
+        cFirstByte == '_')
+    {
+        strName.push_back(cFirstByte);
+    }
+    else
+    {
+        int nByte(cFirstByte);
+        std::stringstream aMessage;
+        aMessage << "Character '" << cFirstByte << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") not supported as first character of an attribute name.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    bool bPrefix(false);
+    char cByte('\0');
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Attribute name incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == ':')
+        {
+            if (bPrefix == true)
+            {
+                throw new std::runtime_error("There can't be two prefixes in attribute name.");
+            }
+
+            bPrefix = true;
+            strName.push_back(cByte);
+        }
+        else if (std::isspace(cByte, m_aLocale) != 0)
+        {
+            cByte = ConsumeWhitespace();
+
+            if (cByte == '\0')
+            {
+                throw new std::runtime_error("Attribute incomplete.");
+            }
+            else if (cByte != '=')
+            {
+                throw new std::runtime_error("Attribute name is malformed.");
+            }
+
+            return true;
+        }
+        else if (cByte == '=')
+        {
+            return true;
+        }
+        else if (std::isalnum(cByte, m_aLocale) == true ||
+                 cByte == '-' ||
+                 cByte == '_' ||
+                 cByte == '.')
+        {
+            strName.push_back(cByte);
+        }
+        else
+        {
+            int nByte(cByte);
+            std::stringstream aMessage;
+            aMessage << "Character '" << cByte << "' (0x"
+                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                     << ") not supported in an attribute name.";
+            throw new std::runtime_error(aMessage.str());
+        }
+
+    } while (true);
+
+    return false;
+}
+
+bool XMLEventReader::HandleAttributeValue(std::unique_ptr<std::string>& pValue)
+{
+    pValue = std::unique_ptr<std::string>(new std::string);
+    char cDelimiter(ConsumeWhitespace());
+
+    if (cDelimiter == '\0')
+    {
+        throw new std::runtime_error("Attribute is missing its value.");
+    }
+    else if (cDelimiter != '\'' &&
+             cDelimiter != '"')
+    {
+        int nByte(cDelimiter);
+        std::stringstream aMessage;
+        aMessage << "Attribute value doesn't start with a delimiter like ''' or '\"', instead, '" << cDelimiter << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") was found.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    char cByte('\0');
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Attribute value incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == cDelimiter)
+        {
+            return true;
+        }
+        else if (cByte == '&')
+        {
+            ResolveEntity(*pValue);
+        }
+        else
+        {
+            pValue->push_back(cByte);
+        }
+
+    } while (true);
+
+    return false;
+}
+
+/**
+ * @brief Consumes an attribute value without creating it, see
+ *     setAttributeProjection().
+ */
+void XMLEventReader::SkipAttributeValue()
+{
+    char cDelimiter(ConsumeWhitespace());
+
+    if (cDelimiter == '\0')
+    {
+        throw new std::runtime_error("Attribute is missing its value.");
+    }
+    else if (cDelimiter != '\'' &&
+             cDelimiter != '"')
+    {
+        int nByte(cDelimiter);
+        std::stringstream aMessage;
+        aMessage << "Attribute value doesn't start with a delimiter like ''' or '\"', instead, '" << cDelimiter << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") was found.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    m_aStream.ignore(std::numeric_limits<std::streamsize>::max(), cDelimiter);
+
+    if (m_aStream.eof() == true)
+    {
+        throw new std::runtime_error("Attribute value incomplete.");
+    }
+
+    if (m_aStream.bad() == true)
+    {
+        throw new std::runtime_error("Stream is bad.");
+    }
+}
+
+/**
+ * @brief Appends the replacement text of the entity or character reference
+ *     after a '&' to strText.
+ */
+void XMLEventReader::ResolveEntity(std::string& strText)
+{
+    m_strEntityName.clear();
+
+    char cByte('\0');
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Entity incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == ';')
+        {
+            break;
+        }
+
+        m_strEntityName.push_back(cByte);
+
+    } while (true);
+
+    if (m_strEntityName.empty() == true)
+    {
+        throw new std::runtime_error("Entity has no name.");
+    }
+
+    if (m_strEntityName.at(0) == '#')
+    {
+        char aBytes[4];
+        strText.append(aBytes, DecodeCharacterReference(m_strEntityName, aBytes));
+        return;
+    }
+
+    std::size_t nTextLength(0);
+    const char* pReplacementText(m_pEntityTable->resolve(m_strEntityName.data(), m_strEntityName.length(), nTextLength));
+
+    if (pReplacementText == nullptr)
+    {
+        std::stringstream aMessage;
+        aMessage << "Unable to resolve entity '&" << m_strEntityName << ";'.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    strText.append(pReplacementText, nTextLength);
+}
+
+/**
+ * @brief Decodes a character reference like "#x20AC" or "#8364".
+ * @param[out] pBytes Receives the character in UTF-8.
+ * @retval Number of bytes in pBytes.
+ */
+std::size_t XMLEventReader::DecodeCharacterReference(const std::string& strReference, char* pBytes)
+{
+    std::uint32_t nBase(10);
+    std::size_t i(1);
+
+    if (strReference.length() > 1 &&
+        strReference.at(1) == 'x')
+    {
+        nBase = 16;
+        i = 2;
+    }
+
+    if (i >= strReference.length())
+    {
+        std::stringstream aMessage;
+        aMessage << "Character reference '&" << strReference << ";' without digits.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    std::uint32_t nCodePoint(0);
+
+    for (; i < strReference.length(); i++)
+    {
+        const char cByte(strReference.at(i));
+        std::uint32_t nDigit(nBase);
+
+        if (cByte >= '0' &&
+            cByte <= '9')
+        {
+            nDigit = cByte - '0';
+        }
+        else if (cByte >= 'a' &&
+                 cByte <= 'f')
+        {
+            nDigit = cByte - 'a' + 10;
+        }
+        else if (cByte >= 'A' &&
+                 cByte <= 'F')
+        {
+            nDigit = cByte - 'A' + 10;
+        }
+
+        if (nDigit >= nBase)
+        {
+            std::stringstream aMessage;
+            aMessage << "Character reference '&" << strReference << ";' is malformed.";
+            throw new std::runtime_error(aMessage.str());
+        }
+
+        nCodePoint = nCodePoint * nBase + nDigit;
+
+        if (nCodePoint > 0x10FFFF)
+        {
+            break;
+        }
+    }
+
+    if (nCodePoint == 0 ||
+        nCodePoint > 0x10FFFF ||
+        (nCodePoint >= 0xD800 &&
+         nCodePoint <= 0xDFFF))
+    {
+        std::stringstream aMessage;
+        aMessage << "Character reference '&" << strReference << ";' isn't a valid character.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    if (nCodePoint < 0x80)
+    {
+        pBytes[0] = static_cast<char>(nCodePoint);
+        return 1;
+    }
+    else if (nCodePoint < 0x800)
+    {
+        pBytes[0] = static_cast<char>(0xC0 | (nCodePoint >> 6));
+        pBytes[1] = static_cast<char>(0x80 | (nCodePoint & 0x3F));
+        return 2;
+    }
+    else if (nCodePoint < 0x10000)
+    {
+        pBytes[0] = static_cast<char>(0xE0 | (nCodePoint >> 12));
+        pBytes[1] = static_cast<char>(0x80 | ((nCodePoint >> 6) & 0x3F));
+        pBytes[2] = static_cast<char>(0x80 | (nCodePoint & 0x3F));
+        return 3;
+    }
+
+    pBytes[0] = static_cast<char>(0xF0 | (nCodePoint >> 18));
+    pBytes[1] = static_cast<char>(0x80 | ((nCodePoint >> 12) & 0x3F));
+    pBytes[2] = static_cast<char>(0x80 | ((nCodePoint >> 6) & 0x3F));
+    pBytes[3] = static_cast<char>(0x80 | (nCodePoint & 0x3F));
+    return 4;
+}
+
+/**
+ * @retval Returns the first non-whitespace character or '\0' in
+ *     case of end-of-file.
+ */
+char XMLEventReader::ConsumeWhitespace()
+{
+    char cByte('\0');
+
+    do
+    {
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            return '\0';
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (std::isspace(cByte, m_aLocale) == 0)
+        {
+            return cByte;
+        }
+
+    } while (true);
+}
+
+/**
+ * @brief Consumes the input up to and including pSequence, like "-->".
+ */
+void XMLEventReader::SkipPast(const char* pSequence)
+{
+    const std::size_t nLength(std::strlen(pSequence));
+    std::size_t nMatched(0);
+
+    while (nMatched < nLength)
+    {
+        char cByte('\0');
+
+        if (nMatched <= 0)
+        {
+            m_aStream.ignore(std::numeric_limits<std::streamsize>::max(), std::char_traits<char>::to_int_type(pSequence[0]));
+            cByte = pSequence[0];
+        }
+        else
+        {
+            m_aStream.get(cByte);
+        }
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Markup incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == pSequence[nMatched])
+        {
+            ++nMatched;
+        }
+        else if (cByte == pSequence[0])
+        {
+            // For "-->", "--->" still ends with a match of "--".
+            if (nMatched < 2 ||
+                pSequence[1] != cByte)
+            {
+                nMatched = 1;
+            }
+        }
+        else
+        {
+            nMatched = 0;
+        }
+    }
+}
+
+/**
+ * @brief Skips the rest of a start tag, stepping over quoted attribute
+ *     values, which may contain '>'.
+ * @param[in] cByte Last byte read of the tag, which isn't '>'.
+ * @retval Returns true for an empty-element tag.
+ */
+bool XMLEventReader::SkipTagRest(char cByte)
+{
+    const std::streamsize nMax(std::numeric_limits<std::streamsize>::max());
+    char cPrevious('\0');
+
+    do
+    {
+        cPrevious = cByte;
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Tag incomplete.");
+        }
+
+        if (cByte == '"' ||
+            cByte == '\'')
+        {
+            m_aStream.ignore(nMax, std::char_traits<char>::to_int_type(cByte));
+        }
+
+    } while (cByte != '>');
+
+    return cPrevious == '/';
+}
+
+/**
+ * @brief Skips input until nDepth more end tags than start tags were
+ *     passed, see skipElement().
+ */
+void XMLEventReader::SkipContent(std::size_t nDepth)
+{
+    const std::streamsize nMax(std::numeric_limits<std::streamsize>::max());
+
+    while (nDepth > 0)
+    {
+        m_aStream.ignore(nMax, '<');
+
+        char cByte('\0');
+        m_aStream.get(cByte);
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Element incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        if (cByte == '/')
+        {
+            m_aStream.ignore(nMax, '>');
+            --nDepth;
+        }
+        else if (cByte == '!')
+        {
+            m_aStream.get(cByte);
+
+            if (cByte == '-')
+            {
+                SkipPast("-->");
+            }
+            else if (cByte == '[')
+            {
+                SkipPast("]]>");
+            }
+            else
+            {
+                m_aStream.ignore(nMax, '>');
+            }
+        }
+        else if (cByte == '?')
+        {
+            SkipPast("?>");
+        }
+        else
+        {
+            if (SkipTagRest(cByte) != true)
+            {
+                ++nDepth;
+            }
+        }
+
+        if (m_aStream.eof() == true)
+        {
+            throw new std::runtime_error("Element incomplete.");
+        }
+
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+    }
+}
+
+/**
+ * @brief Lexes the previous token.
+ * @retval false at the beginning of the input, or with m_bHasPreviousCalled
+ *     reset to false if the token was skipped without events.
+ */
+bool XMLEventReader::HandleRToken()
+{
+    char cByte('\0');
+
+    if (rget(cByte) != true)
+    {
+        return false;
+    }
+
+    if (cByte == '>')
+    {
+        return HandleRTag();
+    }
+    else
+    {
+        return HandleRText(cByte);
+    }
+}
+
+bool XMLEventReader::HandleRTag()
+{
+    char cByte('\0');
+
+    if (rget(cByte) != true)
+    {
+        throw new std::runtime_error("Tag incomplete.");
+    }
+
+    if (cByte == '?')
+    {
+        if ((m_nEventMask & MASK_PROCESSING_INSTRUCTION) != 0)
+        {
+            SkipRPast("?<");
+
+            m_bHasPreviousCalled = false;
+            return false;
+        }
+
+        if (HandleRProcessingInstruction() == true)
+        {
+            return true;
+        }
+        else
+        {
+            m_bHasPreviousCalled = false;
+            return false;
+        }
+    }
+    else if (std::isspace(cByte) != 0)
+    {
+        cByte = ConsumeRWhitespace();
+
+        if (cByte == '\0')
+        {
+            throw new std::runtime_error("Start tag incomplete.");
+        }
+
+        // Either the delimiter of the last attribute value or, if there are
+        // no attributes, the end of the tag name, as handled by
+        // HandleRTagStart().
+
+        std::unique_ptr<StartElement> pStartElement(nullptr);
+
+        if (HandleRTagStart(cByte, pStartElement) == true)
+        {
+            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr));
+            m_aEvents.push(std::move(pEvent));
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if (cByte == '/')
+    {
+        cByte = ConsumeRWhitespace();
+
+        if (cByte == '\0')
+        {
+            throw new std::runtime_error("Start tag incomplete.");
+        }
+
+        // As above, attributes are optional.
+
+        std::unique_ptr<StartElement> pStartElement(nullptr);
+
+        if (HandleRTagStart(cByte, pStartElement) == true)
+        {
+            std::unique_ptr<QName> pName(new QName(pStartElement->getName().getNamespaceURI(),
+                                                   pStartElement->getName().getLocalPart(),
+                                                   pStartElement->getName().getPrefix()));
+            std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
+            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                          std::move(pEndElement),
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr));
+            m_aEvents.push(std::move(pEvent));
+
+            pEvent.reset(new XMLEvent(std::move(pStartElement),
+                                      nullptr,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr));
+            m_aEvents.push(std::move(pEvent));
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if (cByte == '"' ||
+             cByte == '\'')
+    {
+        std::unique_ptr<StartElement> pStartElement(nullptr);
+
+        if (HandleRTagStart(cByte, pStartElement) == true)
+        {
+            std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr,
+                                                          nullptr));
+            m_aEvents.push(std::move(pEvent));
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else if (cByte == '-')
+    {
+        if (rget(cByte) != true)
+        {
+            throw new std::runtime_error("Tag incomplete.");
+        }
+
+        if (cByte == '-')
+        {
+            if ((m_nEventMask & MASK_COMMENT) != 0)
+            {
+                SkipRPast("--!<");
+
+                m_bHasPreviousCalled = false;
+                return false;
+            }
+
+            return HandleRComment();
+        }
+        else
+        {
+            runget();
+            return HandleRTagStartEnd('-');
+        }
+    }
+    else
+    {
+        return HandleRTagStartEnd(cByte);
+    }
+}
+
+bool XMLEventReader::HandleRTagStartEnd(const char& cFirstByte)
+{
+    std::unique_ptr<QName> pName(nullptr);
+
+    if (HandleRTagName(cFirstByte, pName) != true)
+    {
+        throw new std::runtime_error("Tag name incomplete.");
+    }
+
+    char cByte('\0');
+
+    if (rget(cByte) != true)
+    {
+        throw new std::runtime_error("Tag incomplete.");
+    }
+
+    if (cByte == '<')
+    {
+        std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
+        std::unique_ptr<StartElement> pStartElement(new StartElement(std::move(pName), std::move(pAttributes)));
+        std::unique_ptr<XMLEvent> pEvent(new XMLEvent(std::move(pStartElement),
+                                                      nullptr,
+                                                      nullptr,
+                                                      nullptr,
+                                                      nullptr));
+        m_aEvents.push(std::move(pEvent));
+        return true;
+    }
+    else if (cByte == '/')
+    {
+        if (rget(cByte) != true)
+        {
+            throw new std::runtime_error("End tag incomplete.");
+        }
+
+        if (cByte != '<')
+        {
+            throw new std::runtime_error("End tag incomplete.");
+        }
+
+        std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
+        std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                      std::move(pEndElement),
+                                                      nullptr,
+                                                      nullptr,
+                                                      nullptr));
+        m_aEvents.push(std::move(pEvent));
+        return true;
+    }
+    else
+    {
+        int nByte(cByte);
+        std::stringstream aMessage;
+        aMessage << "Character '" << cByte << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") not supported in a tag.";
+        throw new std::runtime_error(aMessage.str());
+    }
+}
+
+bool XMLEventReader::HandleRTagStart(char cByte, std::unique_ptr<StartElement>& pStartElement)
+{
+    std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
+
+    if (cByte == '"' ||
+        cByte == '\'')
+    {
+        HandleRAttributes(cByte, pAttributes);
+
+        if (rget(cByte) != true)
+        {
+            throw new std::runtime_error("Start tag incomplete.");
+        }
+    }
+
+    std::unique_ptr<QName> pName(nullptr);
+
+    if (HandleRTagName(cByte, pName) != true)
+    {
+        throw new std::runtime_error("Tag name incomplete.");
+    }
+
+    if (rget(cByte) != true)
+    {
+        throw new std::runtime_error("Start tag incomplete.");
+    }
+
+    if (cByte != '<')
+    {
+        throw new std::runtime_error("Start tag incomplete.");
+    }
+
+    if (pAttributes->empty() != true)
+    {
+        ProjectAttributes(*pName, *pAttributes);
+    }
+
+    pStartElement.reset(new StartElement(std::move(pName), std::move(pAttributes)));
+
+    return true;
+}
+
+bool XMLEventReader::HandleRTagName(const char& cFirstByte, std::unique_ptr<QName>& pName)
+{
+    if (std::isalnum(cFirstByte, m_aLocale) != true &&
+        cFirstByte != '-' &&
+        cFirstByte != '_' &&
+        cFirstByte != '.')
+    {
+        int nByte(cFirstByte);
+        std::stringstream aMessage;
+        aMessage << "Unknown byte '" << cFirstByte << "' (0x"
+                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                 << ") within element name.";
+        throw new std::runtime_error(aMessage.str());
+    }
+
+    std::unique_ptr<std::string> pNamePrefix(nullptr);
+    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+
+    pNameLocalPart->push_back(cFirstByte);
+
+    char cByte('\0');
+
+    do
+    {
+        if (rget(cByte) != true)
+        {
+            throw new std::runtime_error("Tag name incomplete.");
+        }
+
+        if (cByte == '<' ||
+            cByte == '/')
+        {
+            cByte = pNameLocalPart->back();
+
+            if (std::isalnum(cByte, m_aLocale) != true &&
+                cByte != '_')
+            {
+                throw new std::runtime_error("Tag name malformed.");
+            }
+
+            if (pNamePrefix == nullptr)
+            {
+                pNamePrefix.reset(new std::string);
+            }
+            else
+            {
+                // if (pNamePrefix->length() <= 0) will result in an empty prefix
+                // of the QName anyway, but the reader could complain as well.
+
+                std::reverse(pNamePrefix->begin(), pNamePrefix->end());
+
+                if (pNamePrefix->length() > 0)
+                {
+                    // Other characters were already checked.
+                    cByte = pNamePrefix->at(0);
+
+                    if (std::isalnum(cByte, m_aLocale) != true &&
+                        cByte != '_')
+                    {
+                        int nByte(cByte);
+                        std::stringstream aMessage;
+                        aMessage << "Character '" << cByte << "' (0x"
+                                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                                 << ") not supported as first character of a prefix name.";
+                        throw new std::runtime_error(aMessage.str());
+                    }
+                }
+            }
+
+            std::reverse(pNameLocalPart->begin(), pNameLocalPart->end());
+
+            pName.reset(new QName("", *pNameLocalPart, *pNamePrefix));
+
+            runget();
+
+            return true;
+        }
+        else if (std::isalnum(cByte, m_aLocale) == true ||
+                 cByte == '-' ||
+                 cByte == '_' ||
+                 cByte == '.')
+        {
+            if (pNamePrefix != nullptr)
+            {
+                pNamePrefix->push_back(cByte);
+            }
+            else
+            {
+                pNameLocalPart->push_back(cByte);
+            }
+        }
+        else if (cByte == ':')
+        {
+            if (pNamePrefix != nullptr)
+            {
+                throw new std::runtime_error("There can't be two prefixes in element name.");
+            }
+
+            pNamePrefix.reset(new std::string());
+        }
+        else
+        {
+            int nByte(cByte);
+            std::stringstream aMessage;
+            aMessage << "Character '" << cByte << "' (0x"
+                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                     << ") not supported in element name.";
+            throw new std::runtime_error(aMessage.str());
+        }
+
+    } while (true);
+}
+
+bool XMLEventReader::HandleRText(const char& cFirstByte)
+{
+    std::unique_ptr<std::string> pData(nullptr);
+    char cByte(cFirstByte);
+
+    if ((m_nEventMask & MASK_WHITESPACE) != 0 &&
+        std::isspace(cFirstByte, m_aLocale) != 0)
+    {
+        m_strWhitespace.assign(1, cFirstByte);
+
+        while (true)
+        {
+            if (rget(cByte) != true)
+            {
+                m_bHasPreviousCalled = false;
+                return false;
+            }
+
+            if (std::isspace(cByte, m_aLocale) == 0)
+            {
+                break;
+            }
+
+            m_strWhitespace.push_back(cByte);
+        }
+
+        if (cByte == '>')
+        {
+            runget();
+
+            m_bHasPreviousCalled = false;
+            return false;
+        }
+
+        // Not whitespace only, so the text ends with it (in reverse here).
+        pData.reset(new std::string(m_strWhitespace));
+    }
+    else
+    {
+        pData.reset(new std::string);
+    }
+
+    if (cByte == ';')
+    {
+        ResolveREntity(*pData);
+    }
+    else
+    {
+        pData->push_back(cByte);
+    }
+
+    while (true)
+    {
+        if (rget(cByte) != true)
+        {
+            break;
+        }
+
+        if (cByte == '>')
+        {
+            runget();
+            break;
+        }
+        // '<' and '&' are illegal here, but not a breaking issue when reading
+        // backwards/reverse, and as we're not checking well-formedness yet,
+        // they're handled as normal characters for now.
+        else if (cByte == ';')
+        {
+            ResolveREntity(*pData);
+        }
+        else
+        {
+            pData->push_back(cByte);
+        }
+    }
+
+    std::reverse(pData->begin(), pData->end());
+
+    std::unique_ptr<Characters> pCharacters(new Characters(std::move(pData)));
+    std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                  nullptr,
+                                                  std::move(pCharacters),
+                                                  nullptr,
+                                                  nullptr));
+    m_aEvents.push(std::move(pEvent));
+
+    return true;
+}
+
+bool XMLEventReader::HandleRProcessingInstruction()
+{
+    std::unique_ptr<std::string> pData(new std::string);
+    char cByte('\0');
+    int nMatchCount = 0;
+    int nTargetCount = 0;
+    int nSpaceCount = 0;
+
+    while (nMatchCount < 2)
+    {
+        if (rget(cByte) != true)
+        {
+            throw new std::runtime_error("Processing instruction target or data incomplete.");
+        }
+
+        if (std::isspace(cByte, m_aLocale) != 0)
+        {
+            pData->push_back(cByte);
+
+            if (nTargetCount > 0)
+            {
+                nSpaceCount = 1;
+            }
+            else
+            {
+                ++nSpaceCount;
+            }
+
+            nTargetCount = 0;
+        }
+        else
+        {
+            if (cByte == '?' &&
+                nMatchCount <= 0)
+            {
+                nMatchCount++;
+            }
+            else if (cByte == '<' &&
+                     nMatchCount <= 1)
+            {
+                //nMatchCount++;
+
+                if (pData->length() <= 0)
+                {
+                    throw new std::runtime_error("Processing instruction ended before processing instruction target name could be read.");
+                }
+
+                std::reverse(pData->begin(), pData->end());
+
+                if (nTargetCount <= 0)
+                {
+                    throw new std::runtime_error("Processing instruction without target name.");
+                }
+
+                std::unique_ptr<std::string> pTarget(new std::string(pData->substr(0, nTargetCount)));
+
+                if (pTarget->length() == 3)
+                {
+                    if ((pTarget->at(0) == 'x' ||
+                         pTarget->at(0) == 'X') &&
+                        (pTarget->at(1) == 'm' ||
+                         pTarget->at(1) == 'M') &&
+                        (pTarget->at(2) == 'l' ||
+                         pTarget->at(2) == 'L'))
+                    {
+                        /** @todo This should read the XML declaration instructions instead
+                          * of just consuming/ignoring it. */
+
+                        return false;
+                    }
+                }
+
+                if (std::isalpha(pTarget->at(0), m_aLocale) != true)
+                {
+                    int nByte(pTarget->at(0));
+                    std::stringstream aMessage;
+                    aMessage << "Character '" << pTarget->at(0) << "' (0x"
+                             << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
+                             << ") not supported as first character of an processing instruction target name.";
+                    throw new std::runtime_error(aMessage.str());
+                }
+
+                pData->erase(0, nTargetCount + nSpaceCount);
+
+                std::unique_ptr<ProcessingInstruction> pProcessingInstruction(new ProcessingInstruction(std::move(pTarget), std::move(pData)));
+                std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                              nullptr,
+                                                              nullptr,
+                                                              nullptr,
+                                                              std::move(pProcessingInstruction)));
+                m_aEvents.push(std::move(pEvent));
+
+                return true;
+            }
+            else
+            {
+                if (nMatchCount > 0)
+                {
+                    throw new std::runtime_error("Processing instruction target name interrupted by '?'.");
+                }
+
+                nMatchCount = 0;
+                ++nTargetCount;
+
+                pData->push_back(cByte);
+            }
+        }
+    }
+
+    return false;
+}
+
+bool XMLEventReader::HandleRComment()
+{
+    std::unique_ptr<std::string> pData(new std::string);
+
+    unsigned int nMatchCount = 0;
+    const unsigned int END_SEQUENCE_LENGTH = 4;
+    char cEndSequence[END_SEQUENCE_LENGTH] = { '-', '-', '!', '<' };
+    char cByte('\0');
+
+    do
+    {
+        if (rget(cByte) != true)
+        {
+            throw new std::runtime_error("Comment incomplete.");
+        }
+
+        if (cByte == cEndSequence[nMatchCount])
+        {
+            if (nMatchCount + 1 < END_SEQUENCE_LENGTH)
+            {
+                ++nMatchCount;
+            }
+            else
+            {
+                std::reverse(pData->begin(), pData->end());
+
+                std::unique_ptr<Comment> pComment(new Comment(std::move(pData)));
+                std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
+                                                              nullptr,
+                                                              nullptr,
+                                                              std::move(pComment),
+                                                              nullptr));
+                m_aEvents.push(std::move(pEvent));
+
+                break;
+            }
+        }
+        else
+        {
+            if (nMatchCount > 0)
+            {
+                // Instead of strncpy() and C-style char*.
+                for (unsigned int i = 0; i < nMatchCount; i++)
+                {
+                    pData->push_back(cEndSequence[i]);
+                }
+
+                pData->push_back(cByte);
+                nMatchCount = 0;
+            }
+            else
+            {
+                pData->push_back(cByte);
+            }
+        }
+
+    } while (true);
+
+    return true;
+}
+
+bool XMLEventReader::HandleRAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes)
+{
+    if (pAttributes == nullptr)
+    {
+        throw new std::invalid_argument("nullptr passed.");
+    }
+
+    std::unique_ptr<std::string> pAttributeValue(nullptr);
+    std::unique_ptr<QName> pAttributeName(nullptr);
+
+    HandleRAttributeValue(cFirstByte, pAttributeValue);
+    HandleRAttributeName(pAttributeName);
+
+    pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+
+    char cByte('\0');
+
+    do
     {
         if (rget(cByte) != true)
         {
-            throw new std::runtime_error("End tag incomplete.");
+            throw new std::runtime_error("Attributes incomplete.");
         }
 
-        if (cByte != '<')
+        if (std::isspace(cByte, m_aLocale) != 0)
         {
-            throw new std::runtime_error("End tag incomplete.");
+            // Ignore/consume. Should not be there because
+            // HandleRAttributeName() already consumed whitespace.
+            continue;
         }
+        else if (cByte == '"' ||
+                 cByte == '\'')
+        {
+            HandleRAttributeValue(cByte, pAttributeValue);
+            HandleRAttributeName(pAttributeName);
 
-        std::unique_ptr<EndElement> pEndElement(new EndElement(std::move(pName)));
-        std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                      std::move(pEndElement),
-                                                      nullptr,
-                                                      nullptr,
-                                                      nullptr));
-        m_aEvents.push(std::move(pEvent));
-        return true;
-    }
-    else
-    {
-        int nByte(cByte);
-        std::stringstream aMessage;
-        aMessage << "Character '" << cByte << "' (0x"
-                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                 << ") not supported in a tag.";
-        throw new std::runtime_error(aMessage.str());
-    }
+            pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+        }
+        else
+        {
+            runget();
+            break;
+        }
+
+    } while (true);
+
+    return true;
 }
 
-bool XMLEventReader::HandleRTagStart(char cByte, std::unique_ptr<StartElement>& pStartElement)
+bool XMLEventReader::HandleRAttributeValue(const char& cDelimiter, std::unique_ptr<std::string>& pValue)
 {
-    std::unique_ptr<std::list<std::unique_ptr<Attribute>>> pAttributes(new std::list<std::unique_ptr<Attribute>>);
+    pValue = std::unique_ptr<std::string>(new std::string);
+    char cByte('\0');
 
-    if (cByte == '"' ||
-        cByte == '\'')
+    do
     {
-        HandleRAttributes(cByte, pAttributes);
-
         if (rget(cByte) != true)
         {
-            throw new std::runtime_error("Start tag incomplete.");
+            throw new std::runtime_error("Attribute value incomplete.");
         }
-    }
 
-    std::unique_ptr<QName> pName(nullptr);
+        if (cByte == cDelimiter)
+        {
+            cByte = ConsumeRWhitespace();
 
-    if (HandleRTagName(cByte, pName) != true)
-    {
-        throw new std::runtime_error("Tag name incomplete.");
-    }
+            if (cByte == '\0')
+            {
+                throw new std::runtime_error("Attribute incomplete.");
+            }
+            else if (cByte != '=')
+            {
+                throw new std::runtime_error("Attribute value is malformed.");
+            }
 
-    if (rget(cByte) != true)
-    {
-        throw new std::runtime_error("Start tag incomplete.");
-    }
+            std::reverse(pValue->begin(), pValue->end());
 
-    if (cByte != '<')
-    {
-        throw new std::runtime_error("Start tag incomplete.");
-    }
+            return true;
+        }
+        else if (cByte == ';')
+        {
+            ResolveREntity(cDelimiter, *pValue);
+        }
+        else
+        {
+            pValue->push_back(cByte);
+        }
 
-    pStartElement.reset(new StartElement(std::move(pName), std::move(pAttributes)));
+    } while (true);
 
-    return true;
+    return false;
 }
 
-bool XMLEventReader::HandleRTagName(const char& cFirstByte, std::unique_ptr<QName>& pName)
+bool XMLEventReader::HandleRAttributeName(std::unique_ptr<QName>& pName)
 {
-    if (std::isalnum(cFirstByte, m_aLocale) != true &&
-        cFirstByte != '-' &&
-        cFirstByte != '_' &&
-        cFirstByte != '.')
-    {
-        int nByte(cFirstByte);
-        std::stringstream aMessage;
-        aMessage << "Unknown byte '" << cFirstByte << "' (0x"
-                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                 << ") within element name.";
-        throw new std::runtime_error(aMessage.str());
-    }
-
     std::unique_ptr<std::string> pNamePrefix(nullptr);
     std::unique_ptr<std::string> pNameLocalPart(new std::string());
 
-    pNameLocalPart->push_back(cFirstByte);
+    char cByte(ConsumeRWhitespace());
 
-    char cByte('\0');
+    if (cByte == '\0')
+    {
+        throw new std::runtime_error("Attribute incomplete.");
+    }
+    else if (cByte == ':')
+    {
+        throw new std::runtime_error("Attribute name incomplete.");
+    }
 
     do
     {
-        if (rget(cByte) != true)
-        {
-            throw new std::runtime_error("Tag name incomplete.");
-        }
-
-        if (cByte == '<' ||
-            cByte == '/')
+        if (std::isspace(cByte, m_aLocale) != 0)
         {
-            cByte = pNameLocalPart->back();
+            cByte = ConsumeRWhitespace();
 
-            if (std::isalnum(cByte, m_aLocale) != true &&
-                cByte != '_')
+            if (cByte != '\0')
             {
-                throw new std::runtime_error("Tag name malformed.");
+                runget();
+            }
+            else
+            {
+                throw new std::runtime_error("Attribute name incomplete.");
             }
 
             if (pNamePrefix == nullptr)
@@ -1591,20 +3835,35 @@ bool XMLEventReader::HandleRTagName(const char& cFirstByte, std::unique_ptr<QNam
                         std::stringstream aMessage;
                         aMessage << "Character '" << cByte << "' (0x"
                                  << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                                 << ") not supported as first character of a prefix name.";
+                                 << ") not supported as first character of an attribute prefix name.";
                         throw new std::runtime_error(aMessage.str());
                     }
                 }
             }
 
-            std::reverse(pNameLocalPart->begin(), pNameLocalPart->end());
+            cByte = pNameLocalPart->back();
 
-            pName.reset(new QName("", *pNameLocalPart, *pNamePrefix));
+            if (std::isalnum(cByte, m_aLocale) != true &&
+                    cByte != '_')
+            {
+                throw new std::runtime_error("Attribute name malformed.");
+            }
 
-            runget();
+            std::reverse(pNameLocalPart->begin(), pNameLocalPart->end());
+
+            pName = std::unique_ptr<QName>(new QName("", *pNameLocalPart, *pNamePrefix));
 
             return true;
         }
+        else if (cByte == ':')
+        {
+            if (pNamePrefix != nullptr)
+            {
+                throw new std::runtime_error("There can't be two prefixes in attribute name.");
+            }
+
+            pNamePrefix.reset(new std::string());
+        }
         else if (std::isalnum(cByte, m_aLocale) == true ||
                  cByte == '-' ||
                  cByte == '_' ||
@@ -1619,573 +3878,595 @@ bool XMLEventReader::HandleRTagName(const char& cFirstByte, std::unique_ptr<QNam
                 pNameLocalPart->push_back(cByte);
             }
         }
-        else if (cByte == ':')
-        {
-            if (pNamePrefix != nullptr)
-            {
-                throw new std::runtime_error("There can't be two prefixes in element name.");
-            }
-
-            pNamePrefix.reset(new std::string());
-        }
         else
         {
             int nByte(cByte);
             std::stringstream aMessage;
             aMessage << "Character '" << cByte << "' (0x"
                      << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") not supported in element name.";
+                     << ") not supported in an attribute name.";
             throw new std::runtime_error(aMessage.str());
         }
 
-    } while (true);
-}
-
-bool XMLEventReader::HandleRText(const char& cFirstByte)
-{
-    std::unique_ptr<std::string> pData(new std::string);
-
-    if (cFirstByte == ';')
-    {
-        std::unique_ptr<std::string> pResolvedText(nullptr);
-
-        ResolveREntity(pResolvedText);
-        pData->append(*pResolvedText);
-    }
-    else
-    {
-        pData->push_back(cFirstByte);
-    }
-
-    char cByte('\0');
-
-    while (true)
-    {
         if (rget(cByte) != true)
         {
-            break;
-        }
-
-        if (cByte == '>')
-        {
-            runget();
-            break;
-        }
-        // '<' and '&' are illegal here, but not a breaking issue when reading
-        // backwards/reverse, and as we're not checking well-formedness yet,
-        // they're handled as normal characters for now.
-        else if (cByte == ';')
-        {
-            std::unique_ptr<std::string> pResolvedText(nullptr);
-
-            ResolveREntity(pResolvedText);
-            pData->append(*pResolvedText);
-        }
-        else
-        {
-            pData->push_back(cByte);
+            throw new std::runtime_error("Attribute name incomplete.");
         }
-    }
-
-    std::reverse(pData->begin(), pData->end());
 
-    std::unique_ptr<Characters> pCharacters(new Characters(std::move(pData)));
-    std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                  nullptr,
-                                                  std::move(pCharacters),
-                                                  nullptr,
-                                                  nullptr));
-    m_aEvents.push(std::move(pEvent));
+    } while (true);
 
-    return true;
+    return false;
 }
 
-bool XMLEventReader::HandleRProcessingInstruction()
+void XMLEventReader::ResolveREntity(std::string& strText)
 {
-    std::unique_ptr<std::string> pData(new std::string);
-    char cByte('\0');
-    int nMatchCount = 0;
-    int nTargetCount = 0;
-    int nSpaceCount = 0;
+    // Should the code from ResolveREntity(std::string&)
+    // be duplicated in order to avoid putting the '\0' char onto the
+    // stack during runtime?
+    return ResolveREntity('\0', strText);
+}
 
-    while (nMatchCount < 2)
-    {
-        if (rget(cByte) != true)
-        {
-            throw new std::runtime_error("Processing instruction target or data incomplete.");
-        }
+/**
+ * @brief Appends the reversed replacement text of the entity or character
+ *     reference before a ';' to strText, or the ';' and what was read if
+ *     it isn't one.
+ * @param[in] cDelimiter Delimiter that will abort the attempt to read an entity name.
+ */
+void XMLEventReader::ResolveREntity(const char& cDelimiter, std::string& strText)
+{
+    m_strEntityName.clear();
 
-        if (std::isspace(cByte, m_aLocale) != 0)
-        {
-            pData->push_back(cByte);
+    char cByte('\0');
 
-            if (nTargetCount > 0)
-            {
-                nSpaceCount = 1;
-            }
-            else
-            {
-                ++nSpaceCount;
-            }
+    do
+    {
+        if (rget(cByte) != true)
+        {
+            strText.push_back(';');
+            strText.append(m_strEntityName);
+            return;
+        }
 
-            nTargetCount = 0;
+        if (cByte == '&')
+        {
+            break;
         }
-        else
+        else if (cDelimiter != '\0' &&
+                 cByte == cDelimiter)
         {
-            if (cByte == '?' &&
-                nMatchCount <= 0)
-            {
-                nMatchCount++;
-            }
-            else if (cByte == '<' &&
-                     nMatchCount <= 1)
-            {
-                //nMatchCount++;
-
-                if (pData->length() <= 0)
-                {
-                    throw new std::runtime_error("Processing instruction ended before processing instruction target name could be read.");
-                }
-
-                std::reverse(pData->begin(), pData->end());
+            runget();
+            strText.push_back(';');
+            strText.append(m_strEntityName);
+            return;
+        }
+        /** @todo Check for more illegal characters in entity names (whitespace?) */
+        // '<' is illegal here, but not a breaking issue when reading
+        // backwards/reverse, and as we're not checking well-formedness
+        // yet, they're handled as normal characters for now.
+        else if (cByte == '>' ||
+                 cByte == ';')
+        {
+            runget();
+            strText.push_back(';');
+            strText.append(m_strEntityName);
+            return;
+        }
 
-                if (nTargetCount <= 0)
-                {
-                    throw new std::runtime_error("Processing instruction without target name.");
-                }
+        m_strEntityName.push_back(cByte);
 
-                std::unique_ptr<std::string> pTarget(new std::string(pData->substr(0, nTargetCount)));
+    } while (true);
 
-                if (pTarget->length() == 3)
-                {
-                    if ((pTarget->at(0) == 'x' ||
-                         pTarget->at(0) == 'X') &&
-                        (pTarget->at(1) == 'm' ||
-                         pTarget->at(1) == 'M') &&
-                        (pTarget->at(2) == 'l' ||
-                         pTarget->at(2) == 'L'))
-                    {
-                        /** @todo This should read the XML declaration instructions instead
-                          * of just consuming/ignoring it. */
+    if (m_strEntityName.length() <= 0)
+    {
+        throw new std::runtime_error("Entity has no name.");
+    }
 
-                        return false;
-                    }
-                }
+    if (m_strEntityName.at(m_strEntityName.length() - 1) == '#')
+    {
+        std::reverse(m_strEntityName.begin(), m_strEntityName.end());
 
-                if (std::isalpha(pTarget->at(0), m_aLocale) != true)
-                {
-                    int nByte(pTarget->at(0));
-                    std::stringstream aMessage;
-                    aMessage << "Character '" << pTarget->at(0) << "' (0x"
-                             << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                             << ") not supported as first character of an processing instruction target name.";
-                    throw new std::runtime_error(aMessage.str());
-                }
+        char aBytes[4];
 
-                pData->erase(0, nTargetCount + nSpaceCount);
+        for (std::size_t i = DecodeCharacterReference(m_strEntityName, aBytes); i > 0; i--)
+        {
+            strText.push_back(aBytes[i - 1]);
+        }
 
-                std::unique_ptr<ProcessingInstruction> pProcessingInstruction(new ProcessingInstruction(std::move(pTarget), std::move(pData)));
-                std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                              nullptr,
-                                                              nullptr,
-                                                              nullptr,
-                                                              std::move(pProcessingInstruction)));
-                m_aEvents.push(std::move(pEvent));
+        return;
+    }
 
-                return true;
-            }
-            else
-            {
-                if (nMatchCount > 0)
-                {
-                    throw new std::runtime_error("Processing instruction target name interrupted by '?'.");
-                }
+    std::size_t nTextLength(0);
+    const char* pReplacementText(m_pEntityTable->resolveReverse(m_strEntityName.data(), m_strEntityName.length(), nTextLength));
 
-                nMatchCount = 0;
-                ++nTargetCount;
+    if (pReplacementText == nullptr)
+    {
+        std::reverse(m_strEntityName.begin(), m_strEntityName.end());
 
-                pData->push_back(cByte);
-            }
-        }
+        std::stringstream aMessage;
+        aMessage << "Unable to resolve entity '&" << m_strEntityName << ";'.";
+        throw new std::runtime_error(aMessage.str());
     }
 
-    return false;
+    strText.append(pReplacementText, nTextLength);
 }
 
-bool XMLEventReader::HandleRComment()
+/**
+ * @retval Returns the first non-whitespace character or '\0' in
+ *     case of begin-of-file.
+ */
+char XMLEventReader::ConsumeRWhitespace()
 {
-    std::unique_ptr<std::string> pData(new std::string);
-
-    unsigned int nMatchCount = 0;
-    const unsigned int END_SEQUENCE_LENGTH = 4;
-    char cEndSequence[END_SEQUENCE_LENGTH] = { '-', '-', '!', '<' };
     char cByte('\0');
 
     do
     {
         if (rget(cByte) != true)
         {
-            throw new std::runtime_error("Comment incomplete.");
+            return '\0';
         }
 
-        if (cByte == cEndSequence[nMatchCount])
+        if (std::isspace(cByte, m_aLocale) == 0)
         {
-            if (nMatchCount + 1 < END_SEQUENCE_LENGTH)
-            {
-                ++nMatchCount;
-            }
-            else
-            {
-                std::reverse(pData->begin(), pData->end());
+            return cByte;
+        }
 
-                std::unique_ptr<Comment> pComment(new Comment(std::move(pData)));
-                std::unique_ptr<XMLEvent> pEvent(new XMLEvent(nullptr,
-                                                              nullptr,
-                                                              nullptr,
-                                                              std::move(pComment),
-                                                              nullptr));
-                m_aEvents.push(std::move(pEvent));
+    } while (true);
+}
 
-                break;
-            }
-        }
-        else
+/**
+ * @brief Like SkipPast() while reading backward, with pSequence in reverse,
+ *     like "--!<" for the start of a comment.
+ */
+void XMLEventReader::SkipRPast(const char* pSequence)
+{
+    const std::size_t nLength(std::strlen(pSequence));
+    std::size_t nMatched(0);
+
+    while (nMatched < nLength)
+    {
+        char cByte('\0');
+
+        if (rget(cByte) != true)
         {
-            if (nMatchCount > 0)
-            {
-                // Instead of strncpy() and C-style char*.
-                for (unsigned int i = 0; i < nMatchCount; i++)
-                {
-                    pData->push_back(cEndSequence[i]);
-                }
+            throw new std::runtime_error("Markup incomplete.");
+        }
 
-                pData->push_back(cByte);
-                nMatchCount = 0;
-            }
-            else
+        if (cByte == pSequence[nMatched])
+        {
+            ++nMatched;
+        }
+        else if (cByte == pSequence[0])
+        {
+            if (nMatched < 2 ||
+                pSequence[1] != cByte)
             {
-                pData->push_back(cByte);
+                nMatched = 1;
             }
         }
-
-    } while (true);
-
-    return true;
+        else
+        {
+            nMatched = 0;
+        }
+    }
 }
 
-bool XMLEventReader::HandleRAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes)
+/**
+ * @brief Random access to the input for backward scanning, through a block
+ *     that's loaded with most of it before nOffset.
+ */
+char XMLEventReader::RScanByte(std::vector<char>& aBuffer, std::streamoff& nBufferOffset, const std::streamoff& nOffset)
 {
-    if (pAttributes == nullptr)
+    const std::streamoff BLOCK_SIZE = 65536;
+
+    if (nOffset < nBufferOffset ||
+        nOffset >= nBufferOffset + static_cast<std::streamoff>(aBuffer.size()))
     {
-        throw new std::invalid_argument("nullptr passed.");
-    }
+        nBufferOffset = std::max(nOffset - (BLOCK_SIZE / 4) * 3, static_cast<std::streamoff>(0));
+        aBuffer.resize(BLOCK_SIZE);
 
-    std::unique_ptr<std::string> pAttributeValue(nullptr);
-    std::unique_ptr<QName> pAttributeName(nullptr);
+        m_aStream.clear();
+        m_aStream.seekg(nBufferOffset);
 
-    HandleRAttributeValue(cFirstByte, pAttributeValue);
-    HandleRAttributeName(pAttributeName);
+        if (m_aStream.fail() == true)
+        {
+            throw new std::runtime_error("Stream operation failed.");
+        }
 
-    pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+        m_aStream.read(aBuffer.data(), BLOCK_SIZE);
 
-    char cByte('\0');
+        if (m_aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
 
-    do
+        aBuffer.resize(m_aStream.gcount());
+
+        if (nOffset >= nBufferOffset + static_cast<std::streamoff>(aBuffer.size()))
+        {
+            throw new std::runtime_error("Markup incomplete.");
+        }
+    }
+
+    return aBuffer[nOffset - nBufferOffset];
+}
+
+/**
+ * @brief Finds pStart, like "<!--", backwards from nOffset, where pEnd,
+ *     like "-->", starts, and confirms that this is the first pEnd after
+ *     pStart.
+ * @retval Offset of pStart, or -1 if pEnd at nOffset doesn't end markup.
+ */
+std::streamoff XMLEventReader::RScanMarkupStart(std::vector<char>& aBuffer, std::streamoff& nBufferOffset, const std::streamoff& nOffset, const char* pStart, const char* pEnd)
+{
+    const std::size_t nStartLength(std::strlen(pStart));
+    const std::size_t nEndLength(std::strlen(pEnd));
+    std::streamoff nStart(nOffset);
+
+    while (true)
     {
-        if (rget(cByte) != true)
+        if (nStart <= 0)
         {
-            throw new std::runtime_error("Attributes incomplete.");
+            return -1;
         }
 
-        if (std::isspace(cByte, m_aLocale) != 0)
+        --nStart;
+
+        if (RScanByte(aBuffer, nBufferOffset, nStart) != pStart[0])
         {
-            // Ignore/consume. Should not be there because
-            // HandleRAttributeName() already consumed whitespace.
             continue;
         }
-        else if (cByte == '"' ||
-                 cByte == '\'')
-        {
-            HandleRAttributeValue(cByte, pAttributeValue);
-            HandleRAttributeName(pAttributeName);
 
-            pAttributes->push_back(std::unique_ptr<Attribute>(new Attribute(std::move(pAttributeName), std::move(pAttributeValue))));
+        std::size_t i(1);
+
+        while (i < nStartLength &&
+               nStart + static_cast<std::streamoff>(i) < nOffset &&
+               RScanByte(aBuffer, nBufferOffset, nStart + i) == pStart[i])
+        {
+            ++i;
         }
-        else
+
+        if (i >= nStartLength)
         {
-            runget();
             break;
         }
+    }
+
+    for (std::streamoff nEnd = nStart + nStartLength; nEnd < nOffset; nEnd++)
+    {
+        std::size_t i(0);
+
+        while (i < nEndLength &&
+               RScanByte(aBuffer, nBufferOffset, nEnd + i) == pEnd[i])
+        {
+            ++i;
+        }
 
-    } while (true);
+        if (i >= nEndLength)
+        {
+            return -1;
+        }
+    }
 
-    return true;
+    return nStart;
 }
 
-bool XMLEventReader::HandleRAttributeValue(const char& cDelimiter, std::unique_ptr<std::string>& pValue)
+/**
+ * @brief hasNext() with the history enabled, which takes the token at the
+ *     current position from the history if it's there and otherwise adds
+ *     it to the history.
+ */
+bool XMLEventReader::HistoryNext()
 {
-    pValue = std::unique_ptr<std::string>(new std::string);
-    char cByte('\0');
-
-    do
+    if (m_nHistoryCursor < m_aHistory.size())
     {
-        if (rget(cByte) != true)
-        {
-            throw new std::runtime_error("Attribute value incomplete.");
-        }
+        const HistoryToken& aToken(m_aHistory[m_nHistoryCursor]);
 
-        if (cByte == cDelimiter)
+        for (std::vector<std::unique_ptr<XMLEvent>>::const_iterator iter = aToken.aEvents.begin();
+             iter != aToken.aEvents.end();
+             iter++)
         {
-            cByte = ConsumeRWhitespace();
+            m_aEvents.push((*iter)->clone());
+        }
 
-            if (cByte == '\0')
-            {
-                throw new std::runtime_error("Attribute incomplete.");
-            }
-            else if (cByte != '=')
-            {
-                throw new std::runtime_error("Attribute value is malformed.");
-            }
+        ++m_nHistoryCursor;
+        m_bHistorySeek = true;
 
-            std::reverse(pValue->begin(), pValue->end());
+        return true;
+    }
 
-            return true;
-        }
-        else if (cByte == ';')
-        {
-            std::unique_ptr<std::string> pResolvedText(nullptr);
+    HistoryToken aToken;
+
+    if (m_bHistorySeek == true)
+    {
+        aToken.nBegin = m_aHistory.back().nEnd;
+
+        m_aStream.clear();
+        m_aStream.seekg(aToken.nBegin);
 
-            ResolveREntity(cDelimiter, pResolvedText);
-            pValue->append(*pResolvedText);
+        if (m_aStream.fail() == true)
+        {
+            throw new std::runtime_error("Stream operation failed.");
         }
-        else
+
+        m_bHistorySeek = false;
+    }
+    else
+    {
+        if (m_aStream.eof() == true)
         {
-            pValue->push_back(cByte);
+            return false;
         }
 
-    } while (true);
+        aToken.nBegin = m_aStream.tellg();
 
-    return false;
-}
+        if (aToken.nBegin < 0)
+        {
+            throw new std::runtime_error("Stream operation failed.");
+        }
+    }
 
-bool XMLEventReader::HandleRAttributeName(std::unique_ptr<QName>& pName)
-{
-    std::unique_ptr<std::string> pNamePrefix(nullptr);
-    std::unique_ptr<std::string> pNameLocalPart(new std::string());
+    bool bResult(false);
 
-    char cByte(ConsumeRWhitespace());
+    m_bHistoryLexing = true;
+    m_bHasNextCalled = false;
 
-    if (cByte == '\0')
+    try
     {
-        throw new std::runtime_error("Attribute incomplete.");
+        bResult = hasNext();
     }
-    else if (cByte == ':')
+    catch (std::exception* pException)
     {
-        throw new std::runtime_error("Attribute name incomplete.");
+        m_bHistoryLexing = false;
+        throw pException;
     }
 
-    do
+    m_bHistoryLexing = false;
+
+    if (bResult != true)
     {
-        if (std::isspace(cByte, m_aLocale) != 0)
-        {
-            cByte = ConsumeRWhitespace();
+        return false;
+    }
 
-            if (cByte != '\0')
-            {
-                runget();
-            }
-            else
-            {
-                throw new std::runtime_error("Attribute name incomplete.");
-            }
+    if (m_aStream.eof() == true)
+    {
+        m_aStream.clear();
+        m_aStream.seekg(0, std::ios_base::end);
+    }
 
-            if (pNamePrefix == nullptr)
-            {
-                pNamePrefix.reset(new std::string);
-            }
-            else
-            {
-                // if (pNamePrefix->length() <= 0) will result in an empty prefix
-                // of the QName anyway, but the reader could complain as well.
+    aToken.nEnd = m_aStream.tellg();
 
-                std::reverse(pNamePrefix->begin(), pNamePrefix->end());
+    if (aToken.nEnd < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
 
-                if (pNamePrefix->length() > 0)
-                {
-                    // Other characters were already checked.
-                    cByte = pNamePrefix->at(0);
+    for (std::size_t i = 0, nCount = m_aEvents.size(); i < nCount; i++)
+    {
+        aToken.aEvents.push_back(m_aEvents.front()->clone());
 
-                    if (std::isalnum(cByte, m_aLocale) != true &&
-                        cByte != '_')
-                    {
-                        int nByte(cByte);
-                        std::stringstream aMessage;
-                        aMessage << "Character '" << cByte << "' (0x"
-                                 << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                                 << ") not supported as first character of an attribute prefix name.";
-                        throw new std::runtime_error(aMessage.str());
-                    }
-                }
-            }
+        m_aEvents.push(std::move(m_aEvents.front()));
+        m_aEvents.pop();
+    }
 
-            cByte = pNameLocalPart->back();
+    m_nHistoryEvents += aToken.aEvents.size();
+    m_aHistory.push_back(std::move(aToken));
+    m_nHistoryCursor = m_aHistory.size();
 
-            if (std::isalnum(cByte, m_aLocale) != true &&
-                    cByte != '_')
-            {
-                throw new std::runtime_error("Attribute name malformed.");
-            }
+    while (m_nHistoryEvents > m_nHistorySize &&
+           m_aHistory.size() > 1)
+    {
+        m_nHistoryEvents -= m_aHistory.front().aEvents.size();
+        m_aHistory.pop_front();
+        --m_nHistoryCursor;
+    }
 
-            std::reverse(pNameLocalPart->begin(), pNameLocalPart->end());
+    return true;
+}
 
-            pName = std::unique_ptr<QName>(new QName("", *pNameLocalPart, *pNamePrefix));
+/**
+ * @brief hasPrevious() with the history enabled. The history is in document
+ *     order, so events are reversed, including the attributes, which the
+ *     reverse lexer reports last to first.
+ */
+bool XMLEventReader::HistoryPrevious()
+{
+    if (m_nHistoryCursor > 0)
+    {
+        --m_nHistoryCursor;
 
-            return true;
-        }
-        else if (cByte == ':')
-        {
-            if (pNamePrefix != nullptr)
-            {
-                throw new std::runtime_error("There can't be two prefixes in attribute name.");
-            }
+        const HistoryToken& aToken(m_aHistory[m_nHistoryCursor]);
 
-            pNamePrefix.reset(new std::string());
-        }
-        else if (std::isalnum(cByte, m_aLocale) == true ||
-                 cByte == '-' ||
-                 cByte == '_' ||
-                 cByte == '.')
+        for (std::vector<std::unique_ptr<XMLEvent>>::const_reverse_iterator iter = aToken.aEvents.rbegin();
+             iter != aToken.aEvents.rend();
+             iter++)
         {
-            if (pNamePrefix != nullptr)
-            {
-                pNamePrefix->push_back(cByte);
-            }
-            else
+            std::unique_ptr<XMLEvent> pEvent((*iter)->clone());
+
+            if (pEvent->isStartElement() == true)
             {
-                pNameLocalPart->push_back(cByte);
+                pEvent->asStartElement().getAttributes()->reverse();
             }
-        }
-        else
-        {
-            int nByte(cByte);
-            std::stringstream aMessage;
-            aMessage << "Character '" << cByte << "' (0x"
-                     << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2) << nByte
-                     << ") not supported in an attribute name.";
-            throw new std::runtime_error(aMessage.str());
-        }
 
-        if (rget(cByte) != true)
-        {
-            throw new std::runtime_error("Attribute name incomplete.");
+            m_aEvents.push(std::move(pEvent));
         }
 
-    } while (true);
+        m_bHistorySeek = true;
 
-    return false;
-}
+        return true;
+    }
 
-void XMLEventReader::ResolveREntity(std::unique_ptr<std::string>& pResolvedText)
-{
-    // Should the code from ResolveREntity(std::unique_ptr<std::string>&)
-    // be duplicated in order to avoid putting the '\0' char onto the
-    // stack during runtime?
-    return ResolveREntity('\0', pResolvedText);
-}
+    HistoryToken aToken;
 
-/**
- * @param[in] cDelimiter Delimiter that will abort the attempt to read an entity name.
- */
-void XMLEventReader::ResolveREntity(const char& cDelimiter, std::unique_ptr<std::string>& pResolvedText)
-{
-    if (pResolvedText != nullptr)
+    if (m_bHistorySeek == true)
     {
-        throw new std::invalid_argument("No nullptr passed.");
-    }
+        aToken.nEnd = m_aHistory.front().nBegin;
 
-    std::unique_ptr<std::string> pEntityName(new std::string);
-    char cByte('\0');
+        m_aStream.clear();
+        m_aStream.seekg(aToken.nEnd);
 
-    do
-    {
-        if (rget(cByte) != true)
+        if (m_aStream.fail() == true)
         {
-            pResolvedText = std::move(pEntityName);
-            pResolvedText->insert(0, 1, ';');
-            return;
+            throw new std::runtime_error("Stream operation failed.");
         }
 
-        if (cByte == '&')
-        {
-            break;
-        }
-        else if (cDelimiter != '\0' &&
-                 cByte == cDelimiter)
+        m_bHistorySeek = false;
+    }
+    else
+    {
+        if (m_aStream.eof() == true)
         {
-            runget();
-            pResolvedText = std::move(pEntityName);
-            pResolvedText->insert(0, 1, ';');
-            return;
+            m_aStream.clear();
+            m_aStream.seekg(0, std::ios_base::end);
         }
-        /** @todo Check for more illegal characters in entity names (whitespace?) */
-        // '<' is illegal here, but not a breaking issue when reading
-        // backwards/reverse, and as we're not checking well-formedness
-        // yet, they're handled as normal characters for now.
-        else if (cByte == '>' ||
-                 cByte == ';')
+
+        aToken.nEnd = m_aStream.tellg();
+
+        if (aToken.nEnd < 0)
         {
-            runget();
-            pResolvedText = std::move(pEntityName);
-            pResolvedText->insert(0, 1, ';');
-            return;
+            throw new std::runtime_error("Stream operation failed.");
         }
+    }
 
-        pEntityName->push_back(cByte);
+    bool bResult(false);
 
-    } while (true);
+    m_bHistoryLexing = true;
+    m_bHasPreviousCalled = false;
 
-    if (pEntityName->length() <= 0)
+    try
     {
-        throw new std::runtime_error("Entity has no name.");
+        bResult = hasPrevious();
+    }
+    catch (std::exception* pException)
+    {
+        m_bHistoryLexing = false;
+        throw pException;
+    }
+
+    m_bHistoryLexing = false;
+
+    if (bResult != true)
+    {
+        return false;
     }
 
-    std::map<std::string, std::string>::iterator iter = m_aREntityReplacementDictionary.find(*pEntityName);
+    aToken.nBegin = m_aStream.tellg();
 
-    if (iter != m_aREntityReplacementDictionary.end())
+    if (aToken.nBegin < 0)
     {
-        pResolvedText = std::unique_ptr<std::string>(new std::string(iter->second));
+        throw new std::runtime_error("Stream operation failed.");
     }
-    else
+
+    for (std::size_t i = 0, nCount = m_aEvents.size(); i < nCount; i++)
     {
-        std::reverse(pEntityName->begin(), pEntityName->end());
+        std::unique_ptr<XMLEvent> pEvent(m_aEvents.front()->clone());
 
-        std::stringstream aMessage;
-        aMessage << "Unable to resolve entity '&" << *pEntityName << ";'.";
-        throw new std::runtime_error(aMessage.str());
+        if (pEvent->isStartElement() == true)
+        {
+            pEvent->asStartElement().getAttributes()->reverse();
+        }
+
+        aToken.aEvents.push_back(std::move(pEvent));
+
+        m_aEvents.push(std::move(m_aEvents.front()));
+        m_aEvents.pop();
+    }
+
+    std::reverse(aToken.aEvents.begin(), aToken.aEvents.end());
+
+    m_nHistoryEvents += aToken.aEvents.size();
+    m_aHistory.push_front(std::move(aToken));
+
+    while (m_nHistoryEvents > m_nHistorySize &&
+           m_aHistory.size() > 1)
+    {
+        m_nHistoryEvents -= m_aHistory.back().aEvents.size();
+        m_aHistory.pop_back();
     }
+
+    return true;
 }
 
 /**
- * @retval Returns the first non-whitespace character or '\0' in
- *     case of begin-of-file.
+ * @brief Moves the stream to the current position if events were taken
+ *     from the history, and drops the history, before the stream is used
+ *     other than by lexing or the lexing would change.
  */
-char XMLEventReader::ConsumeRWhitespace()
+void XMLEventReader::ClearHistory()
 {
-    char cByte('\0');
+    if (m_bHistorySeek == true)
+    {
+        std::streamoff nPosition(0);
 
-    do
+        if (m_nHistoryCursor < m_aHistory.size())
+        {
+            nPosition = m_aHistory[m_nHistoryCursor].nBegin;
+        }
+        else
+        {
+            nPosition = m_aHistory.back().nEnd;
+        }
+
+        m_aStream.clear();
+        m_aStream.seekg(nPosition);
+
+        if (m_aStream.fail() == true)
+        {
+            throw new std::runtime_error("Stream operation failed.");
+        }
+
+        m_bHistorySeek = false;
+    }
+
+    m_aHistory.clear();
+    m_nHistoryEvents = 0;
+    m_nHistoryCursor = 0;
+}
+
+void XMLEventReader::TrackElement(XMLEvent& aEvent)
+{
+    ++m_nCheckpointEvents;
+
+    if (aEvent.isStartElement() == true)
     {
-        if (rget(cByte) != true)
+        StartElement& aStartElement(aEvent.asStartElement());
+        const QName& aName(aStartElement.getName());
+        Checkpoint::Element aElement;
+
+        if (aName.getPrefix().empty() == true)
         {
-            return '\0';
+            aElement.strName = aName.getLocalPart();
+        }
+        else
+        {
+            aElement.strName = aName.getPrefix() + ":" + aName.getLocalPart();
         }
 
-        if (std::isspace(cByte, m_aLocale) == 0)
+        for (std::list<std::shared_ptr<Attribute>>::const_iterator iter = aStartElement.getAttributes()->begin();
+             iter != aStartElement.getAttributes()->end();
+             iter++)
         {
-            return cByte;
+            const QName& aAttributeName((*iter)->getName());
+
+            if (aAttributeName.getPrefix() == "xmlns")
+            {
+                aElement.aNamespaces.push_back(std::pair<std::string, std::string>(aAttributeName.getLocalPart(), (*iter)->getValue()));
+            }
+            else if (aAttributeName.getPrefix().empty() == true &&
+                     aAttributeName.getLocalPart() == "xmlns")
+            {
+                aElement.aNamespaces.push_back(std::pair<std::string, std::string>("", (*iter)->getValue()));
+            }
         }
 
-    } while (true);
+        m_aOpenElements.push_back(aElement);
+    }
+    else if (aEvent.isEndElement() == true)
+    {
+        if (m_aOpenElements.empty() != true)
+        {
+            m_aOpenElements.pop_back();
+        }
+    }
 }
 
 bool XMLEventReader::rget(char& c)
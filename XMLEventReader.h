@@ -25,32 +25,116 @@
 
 #include "XMLEvent.h"
 #include "Attribute.h"
+#include "EntityTable.h"
+#include "Checkpoint.h"
 #include <istream>
 #include <locale>
 #include <memory>
 #include <queue>
 #include <map>
+#include <set>
+#include <vector>
+#include <deque>
+#include <functional>
 
 namespace cpprstax
 {
 
 class XMLEventReader
 {
+public:
+    typedef std::function<void(const Checkpoint& aCheckpoint)> CheckpointHandler;
+
+    /** Event types for setEventMask(), combined bitwise. */
+    enum EventMask
+    {
+        MASK_NONE = 0x00,
+        MASK_COMMENT = 0x01,
+        MASK_PROCESSING_INSTRUCTION = 0x02,
+        MASK_WHITESPACE = 0x04
+    };
+
+public:
+    /**
+     * @brief Position and pending events of a reader, as returned by
+     *     XMLEventReader::mark() for XMLEventReader::reset().
+     */
+    class Bookmark
+    {
+    friend class XMLEventReader;
+
+    protected:
+        std::streamoff m_nPosition;
+        bool m_bHasNextCalled;
+        bool m_bHasPreviousCalled;
+        bool m_bEventsAreForwardDirection;
+        std::vector<std::unique_ptr<XMLEvent>> m_aEvents;
+        std::vector<Checkpoint::Element> m_aOpenElements;
+        bool m_bOpenElementsKnown;
+        std::vector<std::string> m_aFilterElements;
+        std::size_t m_nFilterDepth;
+
+    };
+
 public:
     XMLEventReader(std::istream& aStream);
+    XMLEventReader(std::unique_ptr<std::istream> pStream);
     ~XMLEventReader();
 
     bool hasNext();
     std::unique_ptr<XMLEvent> nextEvent();
+    std::size_t nextEvents(std::unique_ptr<XMLEvent>* pEvents, const std::size_t& nMax);
 
     bool hasPrevious();
     std::unique_ptr<XMLEvent> previousEvent();
+    std::size_t previousEvents(std::unique_ptr<XMLEvent>* pEvents, const std::size_t& nMax);
+
+public:
+    std::streamoff seek(const std::streamoff& nOffset);
+    std::streamoff seekPrevious(const std::streamoff& nOffset);
+
+    Bookmark mark();
+    void reset(const Bookmark& aBookmark);
+
+    void skipElement();
+    void skipPreviousElement();
+
+    Checkpoint checkpoint();
+    void resume(const Checkpoint& aCheckpoint);
 
 public:
     int addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText);
+    void setEntityTable(const std::shared_ptr<const EntityTable>& pEntityTable);
+    void setSuppressWhitespace(const bool& bSuppress);
+    void setEventMask(const unsigned int& nMask);
+    void setHistorySize(const std::size_t& nEvents);
+    void setCheckpointHandler(const CheckpointHandler& aHandler, const std::size_t& nInterval);
+    void setPathFilter(const std::vector<std::string>& aPaths);
+    void setAttributeProjection(const std::vector<std::string>& aAttributes);
+    void setAttributeProjection(const std::string& strElementName, const std::vector<std::string>& aAttributes);
+
+protected:
+    /**
+     * @brief Events of a token in document order, with the span of input
+     *     they were lexed from.
+     */
+    struct HistoryToken
+    {
+        std::streamoff nBegin;
+        std::streamoff nEnd;
+        std::vector<std::unique_ptr<XMLEvent>> aEvents;
+    };
+
+    enum FilterResult
+    {
+        FILTER_DELIVER,
+        FILTER_DESCEND,
+        FILTER_SKIP
+    };
 
 protected:
     // Forward direction.
+    bool HandleToken();
     bool HandleTag();
     bool HandleTagStart(const char& cFirstByte);
     bool HandleTagEnd();
@@ -59,14 +143,33 @@ protected:
     bool HandleProcessingInstructionTarget(std::unique_ptr<std::string>& pTarget);
     bool HandleMarkupDeclaration();
     bool HandleComment();
-    bool HandleAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes);
+    bool HandleAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes, const std::set<std::string>* pProjection);
+    void HandleAttribute(const char& cFirstByte, std::list<std::unique_ptr<Attribute>>& aAttributes, const std::set<std::string>* pProjection);
     bool HandleAttributeName(const char& cFirstByte, std::unique_ptr<QName>& pName);
+    bool ScanAttributeName(const char& cFirstByte, std::string& strName);
     bool HandleAttributeValue(std::unique_ptr<std::string>& pValue);
-    void ResolveEntity(std::unique_ptr<std::string>& pResolvedText);
+    void SkipAttributeValue();
+    void ResolveEntity(std::string& strText);
+    static std::size_t DecodeCharacterReference(const std::string& strReference, char* pBytes);
     char ConsumeWhitespace();
+    void SkipPast(const char* pSequence);
+    bool SkipTagRest(char cByte);
+    void SkipContent(std::size_t nDepth);
+
+protected:
+    // Path filter.
+    bool FilterNext(char cByte);
+    FilterResult FilterStartTag(const std::string& strNamePrefix, const std::string& strNameLocalPart);
+    void FilterDrop(const FilterResult& eResult, const std::string& strNamePrefix, const std::string& strNameLocalPart, const bool& bEmpty);
+
+protected:
+    // Attribute projection.
+    const std::set<std::string>* FindAttributeProjection(const std::string& strNamePrefix, const std::string& strNameLocalPart);
+    void ProjectAttributes(const QName& aName, std::list<std::unique_ptr<Attribute>>& aAttributes);
 
 protected:
     // Backward direction.
+    bool HandleRToken();
     bool HandleRTag();
     bool HandleRTagStartEnd(const char& cFirstByte);
     bool HandleRTagStart(char cFirstByte, std::unique_ptr<StartElement>& pStartElement);
@@ -77,22 +180,76 @@ protected:
     bool HandleRAttributes(const char& cFirstByte, std::unique_ptr<std::list<std::unique_ptr<Attribute>>>& pAttributes);
     bool HandleRAttributeValue(const char& cDelimiter, std::unique_ptr<std::string>& pValue);
     bool HandleRAttributeName(std::unique_ptr<QName>& pName);
-    void ResolveREntity(std::unique_ptr<std::string>& pResolvedText);
-    void ResolveREntity(const char& cDelimiter, std::unique_ptr<std::string>& pResolvedText);
+    void ResolveREntity(std::string& strText);
+    void ResolveREntity(const char& cDelimiter, std::string& strText);
     char ConsumeRWhitespace();
+    void SkipRPast(const char* pSequence);
+    std::streamoff SeekMarkupEnd(const std::streamoff& nOffset, const char* pStart, const char* pEnd, std::streamoff& nStart);
+    char RScanByte(std::vector<char>& aBuffer, std::streamoff& nBufferOffset, const std::streamoff& nOffset);
+    std::streamoff RScanMarkupStart(std::vector<char>& aBuffer, std::streamoff& nBufferOffset, const std::streamoff& nOffset, const char* pStart, const char* pEnd);
 
     bool rget(char& c);
     bool runget();
 
 protected:
+    bool HistoryNext();
+    bool HistoryPrevious();
+    void ClearHistory();
+    void TrackElement(XMLEvent& aEvent);
+
+protected:
+    std::unique_ptr<std::istream> m_pStream;
     std::istream& m_aStream;
     std::locale m_aLocale;
     bool m_bHasNextCalled;
     bool m_bHasPreviousCalled;
     std::queue<std::unique_ptr<XMLEvent>> m_aEvents;
     bool m_bEventsAreForwardDirection;
-    std::map<std::string, std::string> m_aEntityReplacementDictionary;
-    std::map<std::string, std::string> m_aREntityReplacementDictionary;
+    /** Event types that aren't reported, see setEventMask(). */
+    unsigned int m_nEventMask;
+    std::shared_ptr<const EntityTable> m_pEntityTable;
+    /** Set if m_pEntityTable is a copy only this reader adds to. */
+    std::shared_ptr<EntityTable> m_pOwnEntityTable;
+    /** Entities added with addToEntityReplacementDictionary() since the last
+      * setEntityTable(), for checkpoint(). */
+    std::map<std::string, std::string> m_aAddedEntities;
+    /** Contiguous tokens lexed last, see setHistorySize(). */
+    std::deque<HistoryToken> m_aHistory;
+    std::size_t m_nHistorySize;
+    std::size_t m_nHistoryEvents;
+    /** Index of the token in m_aHistory that starts at the current position. */
+    std::size_t m_nHistoryCursor;
+    /** Set if the stream isn't at the current position because events were
+      * taken from m_aHistory. */
+    bool m_bHistorySeek;
+    bool m_bHistoryLexing;
+    CheckpointHandler m_aCheckpointHandler;
+    std::size_t m_nCheckpointInterval;
+    std::size_t m_nCheckpointEvents;
+    bool m_bTrackElements;
+    /** Elements open at the current position while m_bTrackElements. */
+    std::vector<Checkpoint::Element> m_aOpenElements;
+    /** Not set after positioning the reader other than by reading forward,
+      * resume() or reset(). */
+    bool m_bOpenElementsKnown;
+    /** Element names of every path of the filter, see setPathFilter(). */
+    std::vector<std::vector<std::string>> m_aFilterPaths;
+    /** Elements open at the current position outside of the matches. */
+    std::vector<std::string> m_aFilterElements;
+    /** Depth inside of a matching element, 0 if outside. */
+    std::size_t m_nFilterDepth;
+    /** Attribute names to keep for elements without their own projection,
+      * see setAttributeProjection(). */
+    std::set<std::string> m_aAttributeProjection;
+    /** Attribute names to keep by element name. */
+    std::map<std::string, std::set<std::string>> m_aElementAttributeProjections;
+    /** Buffer for the attribute name being lexed. */
+    std::string m_strAttributeName;
+    /** Buffer for the entity name being lexed. */
+    std::string m_strEntityName;
+    /** Buffer for leading whitespace of text, dropped if the text turns out
+      * to be whitespace only, see MASK_WHITESPACE. */
+    std::string m_strWhitespace;
 
 };
 
@@ -0,0 +1,266 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XMLFollowReader.cpp
+ * @details The input is lexed token by token. If the end of the file is
+ *     reached within a token, the token might not be written completely yet,
+ *     so the reader returns to where the token started and waits for the
+ *     file to change. On Linux, changes are reported by inotify, otherwise
+ *     the file is polled.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "XMLFollowReader.h"
+#include "XMLEventReader.h"
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace cpprstax
+{
+
+/**
+ * @brief Gives access to the lexer of XMLEventReader token by token, so
+ *     an incomplete token at the end of the input can be lexed again later.
+ */
+class FollowEventReader : public XMLEventReader
+{
+public:
+    FollowEventReader(std::istream& aStream);
+
+public:
+    bool Lex(std::deque<std::unique_ptr<XMLEvent>>& aEvents);
+
+};
+
+FollowEventReader::FollowEventReader(std::istream& aStream):
+  XMLEventReader(aStream)
+{
+
+}
+
+/**
+ * @retval Returns false if there's no complete token at the current
+ *     position yet, which is then unchanged.
+ */
+bool FollowEventReader::Lex(std::deque<std::unique_ptr<XMLEvent>>& aEvents)
+{
+    m_aStream.clear();
+
+    std::streamoff nBegin(m_aStream.tellg());
+
+    if (nBegin < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    bool bComplete(false);
+
+    m_bHasNextCalled = false;
+
+    try
+    {
+        // Text is only complete with the following '<', so if the end of
+        // the input was reached, there might be more of the token to come.
+        bComplete = hasNext() == true &&
+                    m_aStream.eof() != true;
+    }
+    catch (std::exception* pException)
+    {
+        if (m_aStream.eof() != true)
+        {
+            throw pException;
+        }
+
+        delete pException;
+    }
+
+    if (bComplete != true)
+    {
+        std::queue<std::unique_ptr<XMLEvent>>().swap(m_aEvents);
+
+        m_aStream.clear();
+        m_aStream.seekg(nBegin);
+
+        if (m_aStream.fail() == true)
+        {
+            throw new std::runtime_error("Stream operation failed.");
+        }
+
+        return false;
+    }
+
+    while (m_aEvents.empty() != true)
+    {
+        aEvents.push_back(std::move(m_aEvents.front()));
+        m_aEvents.pop();
+    }
+
+    return true;
+}
+
+
+
+XMLFollowReader::XMLFollowReader(const std::string& strFilePath):
+  m_aStream(strFilePath.c_str(), std::ios::in | std::ios::binary),
+  m_nTimeout(0),
+  m_nPollInterval(100),
+  m_bStop(false),
+  m_nNotify(-1)
+{
+    if (m_aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    m_pReader = std::unique_ptr<FollowEventReader>(new FollowEventReader(m_aStream));
+
+#ifdef __linux__
+    m_nNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (m_nNotify >= 0)
+    {
+        if (inotify_add_watch(m_nNotify, strFilePath.c_str(), IN_MODIFY) < 0)
+        {
+            close(m_nNotify);
+            m_nNotify = -1;
+        }
+    }
+#endif
+}
+
+XMLFollowReader::~XMLFollowReader()
+{
+#ifdef __linux__
+    if (m_nNotify >= 0)
+    {
+        close(m_nNotify);
+    }
+#endif
+}
+
+bool XMLFollowReader::hasNext()
+{
+    std::chrono::steady_clock::time_point aStart(std::chrono::steady_clock::now());
+
+    while (m_aEvents.empty() == true)
+    {
+        if (m_bStop.load() == true)
+        {
+            m_bStop.store(false);
+            return false;
+        }
+
+        if (m_pReader->Lex(m_aEvents) == true)
+        {
+            continue;
+        }
+
+        if (m_nTimeout > 0 &&
+            std::chrono::steady_clock::now() - aStart >= std::chrono::milliseconds(m_nTimeout))
+        {
+            return false;
+        }
+
+        Wait();
+    }
+
+    return true;
+}
+
+std::unique_ptr<XMLEvent> XMLFollowReader::nextEvent()
+{
+    if (hasNext() != true)
+    {
+        throw new std::logic_error("Attempted XMLFollowReader::nextEvent() while there isn't one instead of checking XMLFollowReader::hasNext() first.");
+    }
+
+    std::unique_ptr<XMLEvent> pEvent(std::move(m_aEvents.front()));
+    m_aEvents.pop_front();
+
+    return pEvent;
+}
+
+void XMLFollowReader::stop()
+{
+    m_bStop.store(true);
+}
+
+int XMLFollowReader::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+{
+    return m_pReader->addToEntityReplacementDictionary(strName, strReplacementText);
+}
+
+void XMLFollowReader::setSuppressWhitespace(const bool& bSuppress)
+{
+    m_pReader->setSuppressWhitespace(bSuppress);
+}
+
+void XMLFollowReader::setTimeout(const unsigned int& nMilliseconds)
+{
+    m_nTimeout = nMilliseconds;
+}
+
+void XMLFollowReader::setPollInterval(const unsigned int& nMilliseconds)
+{
+    if (nMilliseconds <= 0)
+    {
+        throw new std::invalid_argument("Poll interval needs to be positive.");
+    }
+
+    m_nPollInterval = nMilliseconds;
+}
+
+/**
+ * @brief Waits for a change of the file, but at most for the poll interval.
+ */
+void XMLFollowReader::Wait()
+{
+#ifdef __linux__
+    if (m_nNotify >= 0)
+    {
+        struct pollfd aPoll;
+        aPoll.fd = m_nNotify;
+        aPoll.events = POLLIN;
+        aPoll.revents = 0;
+
+        if (poll(&aPoll, 1, static_cast<int>(m_nPollInterval)) > 0)
+        {
+            char aBuffer[4096];
+
+            // Only the wakeup matters, not the notifications themselves.
+            while (read(m_nNotify, aBuffer, sizeof(aBuffer)) > 0)
+            {
+
+            }
+        }
+
+        return;
+    }
+#endif
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_nPollInterval));
+}
+
+}
@@ -0,0 +1,93 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XMLFollowReader.h
+ * @brief Forward reading of a file that's still growing, like an append-only
+ *     log, which waits for more input at its end instead of ending there.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_XMLFOLLOWREADER_H
+#define _CPPRSTAX_XMLFOLLOWREADER_H
+
+#include "XMLEvent.h"
+#include "EntityTable.h"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <deque>
+#include <atomic>
+
+namespace cpprstax
+{
+
+class FollowEventReader;
+
+class XMLFollowReader
+{
+public:
+    XMLFollowReader(const std::string& strFilePath);
+    ~XMLFollowReader();
+
+    /**
+     * @brief Waits until the next event is complete in the file.
+     * @retval Returns false only if the timeout elapsed without new input
+     *     or stop() was called, in which case hasNext() can be called again
+     *     to keep following.
+     */
+    bool hasNext();
+    std::unique_ptr<XMLEvent> nextEvent();
+
+    /**
+     * @brief Makes a waiting hasNext() return false. Can be called from
+     *     another thread.
+     */
+    void stop();
+
+public:
+    int addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText);
+    void setSuppressWhitespace(const bool& bSuppress);
+    /**
+     * @param[in] nMilliseconds Time hasNext() waits for new input, 0 to wait
+     *     until stop() is called.
+     */
+    void setTimeout(const unsigned int& nMilliseconds);
+    /**
+     * @param[in] nMilliseconds Interval to check the file for new input if
+     *     there's no notification of changes, and to check for stop().
+     */
+    void setPollInterval(const unsigned int& nMilliseconds);
+
+protected:
+    void Wait();
+
+protected:
+    std::ifstream m_aStream;
+    std::unique_ptr<FollowEventReader> m_pReader;
+    std::deque<std::unique_ptr<XMLEvent>> m_aEvents;
+    unsigned int m_nTimeout;
+    unsigned int m_nPollInterval;
+    std::atomic<bool> m_bStop;
+    /** inotify instance watching the file, or -1 if not available. */
+    int m_nNotify;
+
+};
+
+}
+
+#endif
@@ -21,13 +21,45 @@
  */
 
 #include "XMLInputFactory.h"
+#include "TranscodingInputStream.h"
 
 namespace cpprstax
 {
 
+XMLInputFactory::XMLInputFactory():
+  m_bStrictEncoding(false)
+{
+
+}
+
+/**
+ * @details UTF-8 input without byte order mark is read directly. For other
+ *     encodings, the reader is put on top of a TranscodingInputStream, which
+ *     converts to UTF-8 before the lexer sees the data.
+ */
 std::unique_ptr<XMLEventReader> XMLInputFactory::createXMLEventReader(std::istream& stream)
 {
-    return std::unique_ptr<XMLEventReader>(new XMLEventReader(stream));
+    bool bByteOrderMark(false);
+    TranscodingStreamBuffer::Encoding eEncoding(TranscodingStreamBuffer::DetectEncoding(stream, m_bStrictEncoding, bByteOrderMark));
+
+    if (eEncoding == TranscodingStreamBuffer::ENCODING_UTF8 &&
+        bByteOrderMark != true)
+    {
+        return std::unique_ptr<XMLEventReader>(new XMLEventReader(stream));
+    }
+
+    std::unique_ptr<std::istream> pStream(new TranscodingInputStream(stream, eEncoding));
+
+    return std::unique_ptr<XMLEventReader>(new XMLEventReader(std::move(pStream)));
+}
+
+/**
+ * @brief Whether to reject input in an encoding that isn't supported,
+ *     instead of reading ASCII-compatible ones as UTF-8.
+ */
+void XMLInputFactory::setStrictEncoding(const bool& bStrict)
+{
+    m_bStrictEncoding = bStrict;
 }
 
 }
@@ -33,8 +33,15 @@ namespace cpprstax
 
 class XMLInputFactory
 {
+public:
+    XMLInputFactory();
+
 public:
     std::unique_ptr<XMLEventReader> createXMLEventReader(std::istream& stream);
+    void setStrictEncoding(const bool& bStrict);
+
+protected:
+    bool m_bStrictEncoding;
 
 };
 
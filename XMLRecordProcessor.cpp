@@ -0,0 +1,628 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XMLRecordProcessor.cpp
+ * @details The calling thread scans for the byte ranges of the record
+ *     elements, jumping from '<' to '<' and only looking closer at tags with
+ *     the record name, comments and processing instructions. The ranges are
+ *     queued for the worker threads, each of which parses a record with its
+ *     own XMLEventReader. The input needs to be ASCII-compatible, like UTF-8.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "XMLRecordProcessor.h"
+#include "XMLEventReader.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <cstring>
+
+namespace cpprstax
+{
+
+XMLRecordProcessor::XMLRecordProcessor(const std::string& strFilePath, const std::string& strRecordName, const unsigned int& nThreadCount):
+  m_strFilePath(strFilePath),
+  m_strRecordName(strRecordName),
+  m_nThreadCount(nThreadCount),
+  m_pEntityTable(new EntityTable()),
+  m_bSuppressWhitespace(false),
+  m_aScanBuffer(1048576),
+  m_nScanBufferOffset(0),
+  m_nScanBufferLength(0),
+  m_nScanPosition(0),
+  m_nRecordsScanned(0),
+  m_nRecordsDone(0),
+  m_nRecordsDelivered(0),
+  m_bScanComplete(false),
+  m_pException(nullptr)
+{
+    if (m_nThreadCount <= 0)
+    {
+        throw new std::invalid_argument("No threads to parse with.");
+    }
+
+    if (m_strRecordName.empty() == true)
+    {
+        throw new std::invalid_argument("No record element name.");
+    }
+}
+
+int XMLRecordProcessor::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+{
+    return m_pEntityTable->add(strName, strReplacementText);
+}
+
+void XMLRecordProcessor::setSuppressWhitespace(const bool& bSuppress)
+{
+    m_bSuppressWhitespace = bSuppress;
+}
+
+/**
+ * @param[in] aHandler Receives the events of every record. If bOrdered,
+ *     it's called from the calling thread in document order, otherwise
+ *     it's called from the worker threads as soon as a record is parsed,
+ *     so it needs to be thread-safe, but gets parallelized as well.
+ * @retval Number of records.
+ */
+std::size_t XMLRecordProcessor::run(const RecordHandler& aHandler, const bool& bOrdered)
+{
+    std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    m_nScanBufferOffset = 0;
+    m_nScanBufferLength = 0;
+    m_nScanPosition = 0;
+    m_aRecords.clear();
+    m_aResults.clear();
+    m_nRecordsScanned = 0;
+    m_nRecordsDone = 0;
+    m_nRecordsDelivered = 0;
+    m_bScanComplete = false;
+    m_pException = nullptr;
+
+    std::vector<std::thread> aThreads;
+
+    for (unsigned int i = 0; i < m_nThreadCount; i++)
+    {
+        aThreads.push_back(std::thread(&XMLRecordProcessor::Work, this, std::cref(aHandler), bOrdered));
+    }
+
+    // Limits the memory used by records that are queued or parsed,
+    // but not delivered yet.
+    const std::size_t nRecordsPendingMax(m_nThreadCount * 64);
+
+    try
+    {
+        std::streamoff nBegin(0);
+        std::streamoff nEnd(0);
+
+        while (true)
+        {
+            bool bFound(ScanRecord(aStream, nBegin, nEnd));
+
+            std::unique_lock<std::mutex> aLock(m_aMutex);
+
+            if (bFound != true)
+            {
+                m_bScanComplete = true;
+                m_aCondition.notify_all();
+                break;
+            }
+
+            Record aRecord = { m_nRecordsScanned, nBegin, nEnd };
+            m_aRecords.push_back(aRecord);
+            ++m_nRecordsScanned;
+            m_aCondition.notify_all();
+
+            while (m_pException == nullptr &&
+                   m_nRecordsScanned - (bOrdered == true ? m_nRecordsDelivered : m_nRecordsDone) >= nRecordsPendingMax)
+            {
+                if (bOrdered == true)
+                {
+                    if (Deliver(aHandler, aLock) > 0)
+                    {
+                        continue;
+                    }
+                }
+
+                m_aCondition.wait(aLock);
+            }
+
+            if (m_pException != nullptr)
+            {
+                break;
+            }
+
+            if (bOrdered == true)
+            {
+                Deliver(aHandler, aLock);
+            }
+        }
+
+        std::unique_lock<std::mutex> aLock(m_aMutex);
+
+        while (m_pException == nullptr)
+        {
+            if (bOrdered == true)
+            {
+                Deliver(aHandler, aLock);
+            }
+
+            if ((bOrdered == true ? m_nRecordsDelivered : m_nRecordsDone) >= m_nRecordsScanned)
+            {
+                break;
+            }
+
+            m_aCondition.wait(aLock);
+        }
+    }
+    catch (...)
+    {
+        {
+            std::unique_lock<std::mutex> aLock(m_aMutex);
+
+            m_bScanComplete = true;
+            m_aRecords.clear();
+            m_aCondition.notify_all();
+        }
+
+        for (std::vector<std::thread>::iterator iter = aThreads.begin();
+             iter != aThreads.end();
+             iter++)
+        {
+            iter->join();
+        }
+
+        throw;
+    }
+
+    for (std::vector<std::thread>::iterator iter = aThreads.begin();
+         iter != aThreads.end();
+         iter++)
+    {
+        iter->join();
+    }
+
+    if (m_pException != nullptr)
+    {
+        std::exception* pException(m_pException);
+        m_pException = nullptr;
+        throw pException;
+    }
+
+    return m_nRecordsScanned;
+}
+
+/**
+ * @brief Thread function.
+ */
+void XMLRecordProcessor::Work(const RecordHandler& aHandler, const bool& bOrdered)
+{
+    try
+    {
+        std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+        if (aStream.is_open() != true)
+        {
+            throw new std::runtime_error("Couldn't open input file.");
+        }
+
+        while (true)
+        {
+            Record aRecord;
+
+            {
+                std::unique_lock<std::mutex> aLock(m_aMutex);
+
+                while (m_aRecords.empty() == true &&
+                       m_bScanComplete != true &&
+                       m_pException == nullptr)
+                {
+                    m_aCondition.wait(aLock);
+                }
+
+                if (m_aRecords.empty() == true ||
+                    m_pException != nullptr)
+                {
+                    return;
+                }
+
+                aRecord = m_aRecords.front();
+                m_aRecords.pop_front();
+            }
+
+            std::vector<std::unique_ptr<XMLEvent>> aEvents;
+
+            ParseRecord(aStream, aRecord, aEvents);
+
+            if (bOrdered != true)
+            {
+                aHandler(aRecord.nIndex, aEvents);
+            }
+
+            std::unique_lock<std::mutex> aLock(m_aMutex);
+
+            if (bOrdered == true)
+            {
+                m_aResults[aRecord.nIndex] = std::move(aEvents);
+            }
+
+            ++m_nRecordsDone;
+            m_aCondition.notify_all();
+        }
+    }
+    catch (std::exception* pException)
+    {
+        std::unique_lock<std::mutex> aLock(m_aMutex);
+
+        if (m_pException == nullptr)
+        {
+            m_pException = pException;
+        }
+        else
+        {
+            delete pException;
+        }
+
+        m_aCondition.notify_all();
+    }
+}
+
+void XMLRecordProcessor::ParseRecord(std::istream& aStream, const Record& aRecord, std::vector<std::unique_ptr<XMLEvent>>& aEvents)
+{
+    std::string strRecord(aRecord.nEnd - aRecord.nBegin, '\0');
+
+    aStream.clear();
+    aStream.seekg(aRecord.nBegin);
+    aStream.read(&strRecord[0], strRecord.length());
+
+    if (aStream.gcount() != static_cast<std::streamsize>(strRecord.length()))
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    std::istringstream aRecordStream(strRecord);
+    XMLEventReader aReader(aRecordStream);
+
+    aReader.setSuppressWhitespace(m_bSuppressWhitespace);
+
+    aReader.setEntityTable(m_pEntityTable);
+
+    while (aReader.hasNext() == true)
+    {
+        aEvents.push_back(aReader.nextEvent());
+    }
+}
+
+/**
+ * @brief Calls the handler for the parsed records that are next in document
+ *     order, with aLock released during the calls.
+ */
+std::size_t XMLRecordProcessor::Deliver(const RecordHandler& aHandler, std::unique_lock<std::mutex>& aLock)
+{
+    std::size_t nCount(0);
+
+    while (true)
+    {
+        std::map<std::size_t, std::vector<std::unique_ptr<XMLEvent>>>::iterator iter = m_aResults.find(m_nRecordsDelivered);
+
+        if (iter == m_aResults.end())
+        {
+            break;
+        }
+
+        std::vector<std::unique_ptr<XMLEvent>> aEvents(std::move(iter->second));
+        m_aResults.erase(iter);
+
+        aLock.unlock();
+        aHandler(m_nRecordsDelivered, aEvents);
+        aLock.lock();
+
+        ++m_nRecordsDelivered;
+        ++nCount;
+    }
+
+    return nCount;
+}
+
+/**
+ * @retval Returns false if there are no more records.
+ */
+bool XMLRecordProcessor::ScanRecord(std::istream& aStream, std::streamoff& nBegin, std::streamoff& nEnd)
+{
+    std::streamoff nPosition(m_nScanPosition);
+    std::size_t nDepth(0);
+
+    while (true)
+    {
+        nPosition = ScanFind(aStream, nPosition, '<');
+
+        if (nPosition < 0)
+        {
+            if (nDepth > 0)
+            {
+                throw new std::runtime_error("Record incomplete.");
+            }
+
+            return false;
+        }
+
+        int cByte(ScanByte(aStream, nPosition + 1));
+
+        if (cByte == '!')
+        {
+            if (ScanByte(aStream, nPosition + 2) == '-' &&
+                ScanByte(aStream, nPosition + 3) == '-')
+            {
+                nPosition = ScanSequenceEnd(aStream, nPosition + 4, '-', true) + 1;
+            }
+            else
+            {
+                nPosition = ScanSequenceEnd(aStream, nPosition + 2, '\0', false) + 1;
+            }
+        }
+        else if (cByte == '?')
+        {
+            nPosition = ScanSequenceEnd(aStream, nPosition + 2, '?', false) + 1;
+        }
+        else if (cByte == '/')
+        {
+            std::streamoff nTagBegin(nPosition);
+            nPosition += 2;
+
+            if (ScanTagName(aStream, nPosition) == true &&
+                nDepth > 0)
+            {
+                bool bEmpty(false);
+                nPosition = ScanTagEnd(aStream, nPosition, bEmpty) + 1;
+
+                --nDepth;
+
+                if (nDepth <= 0)
+                {
+                    nEnd = nPosition;
+                    m_nScanPosition = nPosition;
+                    return true;
+                }
+            }
+            else if (nPosition <= nTagBegin + 2)
+            {
+                throw new std::runtime_error("End tag without name.");
+            }
+        }
+        else
+        {
+            std::streamoff nTagBegin(nPosition);
+            nPosition += 1;
+
+            if (ScanTagName(aStream, nPosition) == true)
+            {
+                bool bEmpty(false);
+                nPosition = ScanTagEnd(aStream, nPosition, bEmpty) + 1;
+
+                if (nDepth <= 0)
+                {
+                    nBegin = nTagBegin;
+                }
+
+                if (bEmpty == true)
+                {
+                    if (nDepth <= 0)
+                    {
+                        nEnd = nPosition;
+                        m_nScanPosition = nPosition;
+                        return true;
+                    }
+                }
+                else
+                {
+                    ++nDepth;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reads a tag name, leaving nPosition after it.
+ * @retval Whether it's the record name.
+ */
+bool XMLRecordProcessor::ScanTagName(std::istream& aStream, std::streamoff& nPosition)
+{
+    std::size_t nMatchCount(0);
+    bool bMatch(true);
+
+    while (true)
+    {
+        int cByte(ScanByte(aStream, nPosition));
+
+        if (cByte < 0)
+        {
+            throw new std::runtime_error("Tag incomplete.");
+        }
+
+        if (cByte == '>' ||
+            cByte == '/' ||
+            cByte == ' ' ||
+            cByte == '\t' ||
+            cByte == '\r' ||
+            cByte == '\n')
+        {
+            break;
+        }
+
+        if (bMatch == true &&
+            nMatchCount < m_strRecordName.length() &&
+            m_strRecordName[nMatchCount] == cByte)
+        {
+            ++nMatchCount;
+        }
+        else
+        {
+            bMatch = false;
+        }
+
+        ++nPosition;
+    }
+
+    return bMatch == true && nMatchCount == m_strRecordName.length();
+}
+
+/**
+ * @brief Finds the '>' that ends a tag, which might also
+ *     occur in attribute values.
+ * @param[out] bEmpty Whether it's an empty start + end tag.
+ */
+std::streamoff XMLRecordProcessor::ScanTagEnd(std::istream& aStream, std::streamoff nPosition, bool& bEmpty)
+{
+    int cPrevious('\0');
+
+    while (true)
+    {
+        int cByte(ScanByte(aStream, nPosition));
+
+        if (cByte < 0)
+        {
+            throw new std::runtime_error("Tag incomplete.");
+        }
+
+        if (cByte == '"' ||
+            cByte == '\'')
+        {
+            nPosition = ScanFind(aStream, nPosition + 1, static_cast<char>(cByte));
+
+            if (nPosition < 0)
+            {
+                throw new std::runtime_error("Attribute value incomplete.");
+            }
+        }
+        else if (cByte == '>')
+        {
+            bEmpty = (cPrevious == '/');
+            return nPosition;
+        }
+
+        cPrevious = cByte;
+        ++nPosition;
+    }
+}
+
+/**
+ * @brief Finds the '>' that is preceded by cPrevious (or by two of
+ *     them if bTwice), as for the end of comments and processing
+ *     instructions.
+ */
+std::streamoff XMLRecordProcessor::ScanSequenceEnd(std::istream& aStream, std::streamoff nPosition, const char& cPrevious, const bool& bTwice)
+{
+    const std::streamoff nBegin(nPosition);
+
+    while (true)
+    {
+        nPosition = ScanFind(aStream, nPosition, '>');
+
+        if (nPosition < 0)
+        {
+            throw new std::runtime_error("Markup incomplete.");
+        }
+
+        if (cPrevious == '\0')
+        {
+            return nPosition;
+        }
+
+        if (nPosition - (bTwice == true ? 2 : 1) >= nBegin &&
+            ScanByte(aStream, nPosition - 1) == cPrevious &&
+            (bTwice != true ||
+             ScanByte(aStream, nPosition - 2) == cPrevious))
+        {
+            return nPosition;
+        }
+
+        ++nPosition;
+    }
+}
+
+/**
+ * @retval Offset of the next cByte at or after nOffset, or -1.
+ */
+std::streamoff XMLRecordProcessor::ScanFind(std::istream& aStream, std::streamoff nOffset, const char& cByte)
+{
+    while (true)
+    {
+        if (nOffset < m_nScanBufferOffset ||
+            nOffset >= m_nScanBufferOffset + m_nScanBufferLength)
+        {
+            if (ScanByte(aStream, nOffset) < 0)
+            {
+                return -1;
+            }
+        }
+
+        const char* pBegin(m_aScanBuffer.data() + (nOffset - m_nScanBufferOffset));
+        const void* pFound(std::memchr(pBegin, cByte, m_nScanBufferLength - (nOffset - m_nScanBufferOffset)));
+
+        if (pFound != nullptr)
+        {
+            return nOffset + (static_cast<const char*>(pFound) - pBegin);
+        }
+
+        nOffset = m_nScanBufferOffset + m_nScanBufferLength;
+    }
+}
+
+/**
+ * @retval Byte at nOffset, or -1 at the end of the input.
+ */
+int XMLRecordProcessor::ScanByte(std::istream& aStream, const std::streamoff& nOffset)
+{
+    if (nOffset < m_nScanBufferOffset ||
+        nOffset >= m_nScanBufferOffset + m_nScanBufferLength)
+    {
+        aStream.clear();
+        aStream.seekg(nOffset);
+
+        if (aStream.fail() == true)
+        {
+            throw new std::runtime_error("Stream operation failed.");
+        }
+
+        aStream.read(m_aScanBuffer.data(), m_aScanBuffer.size());
+
+        if (aStream.bad() == true)
+        {
+            throw new std::runtime_error("Stream is bad.");
+        }
+
+        m_nScanBufferOffset = nOffset;
+        m_nScanBufferLength = aStream.gcount();
+
+        if (m_nScanBufferLength <= 0)
+        {
+            return -1;
+        }
+    }
+
+    return static_cast<unsigned char>(m_aScanBuffer[nOffset - m_nScanBufferOffset]);
+}
+
+}
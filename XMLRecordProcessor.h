@@ -0,0 +1,103 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XMLRecordProcessor.h
+ * @brief Parses the repeated record elements of a document in parallel.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_XMLRECORDPROCESSOR_H
+#define _CPPRSTAX_XMLRECORDPROCESSOR_H
+
+#include "XMLEvent.h"
+#include "EntityTable.h"
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+namespace cpprstax
+{
+
+class XMLRecordProcessor
+{
+public:
+    typedef std::function<void(const std::size_t& nRecord, std::vector<std::unique_ptr<XMLEvent>>& aEvents)> RecordHandler;
+
+public:
+    XMLRecordProcessor(const std::string& strFilePath, const std::string& strRecordName, const unsigned int& nThreadCount);
+
+public:
+    int addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText);
+    void setSuppressWhitespace(const bool& bSuppress);
+
+    std::size_t run(const RecordHandler& aHandler, const bool& bOrdered);
+
+protected:
+    struct Record
+    {
+        std::size_t nIndex;
+        std::streamoff nBegin;
+        std::streamoff nEnd;
+    };
+
+protected:
+    void Work(const RecordHandler& aHandler, const bool& bOrdered);
+    void ParseRecord(std::istream& aStream, const Record& aRecord, std::vector<std::unique_ptr<XMLEvent>>& aEvents);
+    std::size_t Deliver(const RecordHandler& aHandler, std::unique_lock<std::mutex>& aLock);
+
+    // Scanning for record boundaries.
+    bool ScanRecord(std::istream& aStream, std::streamoff& nBegin, std::streamoff& nEnd);
+    bool ScanTagName(std::istream& aStream, std::streamoff& nPosition);
+    std::streamoff ScanTagEnd(std::istream& aStream, std::streamoff nPosition, bool& bEmpty);
+    std::streamoff ScanSequenceEnd(std::istream& aStream, std::streamoff nPosition, const char& cPrevious, const bool& bTwice);
+    std::streamoff ScanFind(std::istream& aStream, std::streamoff nOffset, const char& cByte);
+    int ScanByte(std::istream& aStream, const std::streamoff& nOffset);
+
+protected:
+    std::string m_strFilePath;
+    std::string m_strRecordName;
+    unsigned int m_nThreadCount;
+    std::shared_ptr<EntityTable> m_pEntityTable;
+    bool m_bSuppressWhitespace;
+
+    std::vector<char> m_aScanBuffer;
+    std::streamoff m_nScanBufferOffset;
+    std::streamoff m_nScanBufferLength;
+    std::streamoff m_nScanPosition;
+
+    std::mutex m_aMutex;
+    std::condition_variable m_aCondition;
+    std::deque<Record> m_aRecords;
+    std::map<std::size_t, std::vector<std::unique_ptr<XMLEvent>>> m_aResults;
+    std::size_t m_nRecordsScanned;
+    std::size_t m_nRecordsDone;
+    std::size_t m_nRecordsDelivered;
+    bool m_bScanComplete;
+    std::exception* m_pException;
+
+};
+
+}
+
+#endif
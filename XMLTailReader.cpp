@@ -0,0 +1,257 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XMLTailReader.cpp
+ * @details The input is lexed backwards from the end, so only the tail of
+ *     the file is read, up to the start tag of the earliest record that's
+ *     requested. A record that's still being written at the end of the file
+ *     makes reverse lexing fail or leaves start tags without end tags, which
+ *     are both ignored until the end tag of the first complete record is
+ *     found.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "XMLTailReader.h"
+#include "SpanEventReader.h"
+#include "StartElement.h"
+#include "EndElement.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+namespace cpprstax
+{
+
+XMLTailReader::XMLTailReader(const std::string& strFilePath, const std::string& strRecordName):
+  m_strFilePath(strFilePath),
+  m_strRecordName(strRecordName),
+  m_pEntityTable(new EntityTable()),
+  m_bSuppressWhitespace(false)
+{
+    if (m_strRecordName.empty() == true)
+    {
+        throw new std::invalid_argument("No record element name.");
+    }
+}
+
+int XMLTailReader::addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText)
+{
+    return m_pEntityTable->add(strName, strReplacementText);
+}
+
+void XMLTailReader::setSuppressWhitespace(const bool& bSuppress)
+{
+    m_bSuppressWhitespace = bSuppress;
+}
+
+/**
+ * @retval The events of the last nCount records, or of all of them if there
+ *     are fewer, in document order.
+ */
+std::vector<std::unique_ptr<XMLEvent>> XMLTailReader::readLast(const std::size_t& nCount)
+{
+    std::ifstream aStream(m_strFilePath.c_str(), std::ios::in | std::ios::binary);
+
+    if (aStream.is_open() != true)
+    {
+        throw new std::runtime_error("Couldn't open input file.");
+    }
+
+    aStream.seekg(0, std::ios_base::end);
+    std::streamoff nEnd(aStream.tellg());
+
+    if (nEnd < 0)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    std::vector<std::vector<std::unique_ptr<XMLEvent>>> aRecords;
+
+    while (nCount > 0)
+    {
+        // Nothing after the last '>' can be a complete token.
+        nEnd = FindTagEnd(aStream, nEnd);
+
+        if (nEnd <= 0)
+        {
+            break;
+        }
+
+        try
+        {
+            ReadRecords(aStream, nEnd, nCount, aRecords);
+            break;
+        }
+        catch (std::exception* pException)
+        {
+            if (aRecords.empty() != true)
+            {
+                throw pException;
+            }
+
+            // The last '>' might be part of an incomplete record, like in an
+            // attribute value or comment, so try again from the one before.
+            delete pException;
+            --nEnd;
+        }
+    }
+
+    std::vector<std::unique_ptr<XMLEvent>> aEvents;
+
+    for (std::vector<std::vector<std::unique_ptr<XMLEvent>>>::reverse_iterator iter = aRecords.rbegin();
+         iter != aRecords.rend();
+         iter++)
+    {
+        for (std::vector<std::unique_ptr<XMLEvent>>::reverse_iterator iterEvent = iter->rbegin();
+             iterEvent != iter->rend();
+             iterEvent++)
+        {
+            aEvents.push_back(std::move(*iterEvent));
+        }
+    }
+
+    return aEvents;
+}
+
+/**
+ * @param[out] aRecords The events of every record in reverse order, the last
+ *     record first.
+ */
+void XMLTailReader::ReadRecords(std::istream& aStream, const std::streamoff& nEnd, const std::size_t& nCount, std::vector<std::vector<std::unique_ptr<XMLEvent>>>& aRecords)
+{
+    aStream.clear();
+    aStream.seekg(nEnd);
+
+    if (aStream.fail() == true)
+    {
+        throw new std::runtime_error("Stream operation failed.");
+    }
+
+    SpanEventReader aReader(aStream, nEnd);
+
+    aReader.setSuppressWhitespace(m_bSuppressWhitespace);
+    aReader.setEntityTable(m_pEntityTable);
+
+    std::vector<std::unique_ptr<XMLEvent>> aEvents;
+    std::streamoff nBegin(0);
+    // Relative to nEnd, so elements that started before become negative.
+    long nDepth(0);
+    long nRecordDepth(0);
+    bool bInRecord(false);
+
+    while (aRecords.size() < nCount ||
+           bInRecord == true)
+    {
+        aEvents.clear();
+
+        if (aReader.lexPrevious(aEvents, nBegin) != true)
+        {
+            if (bInRecord == true)
+            {
+                throw new std::runtime_error("Record incomplete.");
+            }
+
+            break;
+        }
+
+        for (std::vector<std::unique_ptr<XMLEvent>>::iterator iter = aEvents.begin();
+             iter != aEvents.end();
+             iter++)
+        {
+            if ((*iter)->isEndElement() == true)
+            {
+                if (bInRecord != true &&
+                    aRecords.size() < nCount &&
+                    IsRecordName((*iter)->asEndElement().getName()) == true)
+                {
+                    aRecords.push_back(std::vector<std::unique_ptr<XMLEvent>>());
+                    nRecordDepth = nDepth;
+                    bInRecord = true;
+                }
+
+                ++nDepth;
+            }
+            else if ((*iter)->isStartElement() == true)
+            {
+                --nDepth;
+            }
+
+            if (bInRecord == true)
+            {
+                aRecords.back().push_back(std::move(*iter));
+
+                if (nDepth == nRecordDepth)
+                {
+                    bInRecord = false;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @retval Position after the last '>' before nOffset, or 0 if there's none.
+ */
+std::streamoff XMLTailReader::FindTagEnd(std::istream& aStream, std::streamoff nOffset)
+{
+    const std::streamoff BLOCK_SIZE = 4096;
+    char aBlock[BLOCK_SIZE];
+
+    while (nOffset > 0)
+    {
+        std::streamoff nBlockOffset(std::max(nOffset - BLOCK_SIZE, static_cast<std::streamoff>(0)));
+
+        aStream.clear();
+        aStream.seekg(nBlockOffset);
+        aStream.read(aBlock, nOffset - nBlockOffset);
+
+        if (aStream.gcount() != nOffset - nBlockOffset)
+        {
+            throw new std::runtime_error("Stream operation failed.");
+        }
+
+        for (std::streamoff i = nOffset - nBlockOffset; i > 0; i--)
+        {
+            if (aBlock[i - 1] == '>')
+            {
+                return nBlockOffset + i;
+            }
+        }
+
+        nOffset = nBlockOffset;
+    }
+
+    return 0;
+}
+
+bool XMLTailReader::IsRecordName(const QName& aName)
+{
+    const std::string& strPrefix(aName.getPrefix());
+
+    if (strPrefix.empty() == true)
+    {
+        return aName.getLocalPart() == m_strRecordName;
+    }
+
+    return m_strRecordName.length() == strPrefix.length() + 1 + aName.getLocalPart().length() &&
+           m_strRecordName.compare(0, strPrefix.length(), strPrefix) == 0 &&
+           m_strRecordName[strPrefix.length()] == ':' &&
+           m_strRecordName.compare(strPrefix.length() + 1, std::string::npos, aName.getLocalPart()) == 0;
+}
+
+}
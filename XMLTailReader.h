@@ -0,0 +1,65 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XMLTailReader.h
+ * @brief Reads the last record elements of a document, like of an
+ *     append-only log, without reading the rest of the file.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_XMLTAILREADER_H
+#define _CPPRSTAX_XMLTAILREADER_H
+
+#include "XMLEvent.h"
+#include "QName.h"
+#include "EntityTable.h"
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cpprstax
+{
+
+class XMLTailReader
+{
+public:
+    XMLTailReader(const std::string& strFilePath, const std::string& strRecordName);
+
+public:
+    int addToEntityReplacementDictionary(const std::string& strName, const std::string& strReplacementText);
+    void setSuppressWhitespace(const bool& bSuppress);
+
+    std::vector<std::unique_ptr<XMLEvent>> readLast(const std::size_t& nCount);
+
+protected:
+    void ReadRecords(std::istream& aStream, const std::streamoff& nEnd, const std::size_t& nCount, std::vector<std::vector<std::unique_ptr<XMLEvent>>>& aRecords);
+    std::streamoff FindTagEnd(std::istream& aStream, std::streamoff nOffset);
+    bool IsRecordName(const QName& aName);
+
+protected:
+    std::string m_strFilePath;
+    std::string m_strRecordName;
+    std::shared_ptr<EntityTable> m_pEntityTable;
+    bool m_bSuppressWhitespace;
+
+};
+
+}
+
+#endif
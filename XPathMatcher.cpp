@@ -0,0 +1,416 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XPathMatcher.cpp
+ * @details Every query is a sequence of steps, which are the states of a
+ *     nondeterministic automaton over the element names, interned to numbers.
+ *     A descendant step stays active for the elements below. The set of
+ *     active steps of all queries is tracked on a stack of open elements,
+ *     and the sets and the transitions between them are cached, so after
+ *     warming up, a start tag costs one name lookup and one transition
+ *     lookup, no matter how many queries there are. Transitions that depend
+ *     on attribute predicates are evaluated every time. Subtrees in which
+ *     no query can match are skipped with XMLEventReader::skipElement().
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "XPathMatcher.h"
+#include "StartElement.h"
+#include "Attribute.h"
+#include "QName.h"
+#include <stdexcept>
+#include <algorithm>
+
+namespace cpprstax
+{
+
+XPathMatcher::XPathMatcher()
+{
+
+}
+
+/**
+ * @param[in] strQuery Absolute location path of child ('/') and descendant
+ *     ('//') steps with element names or '*', each optionally with
+ *     predicates for the presence or the value of attributes, like
+ *     "//entry[@type='post']/title" or "/feed/entry[@id]". Names are compared
+ *     with their prefix, without resolving namespaces.
+ * @retval Number of the query, as passed to the MatchHandler.
+ */
+std::size_t XPathMatcher::addQuery(const std::string& strQuery)
+{
+    if (strQuery.empty() == true ||
+        strQuery[0] != '/')
+    {
+        throw new std::invalid_argument("Query isn't absolute.");
+    }
+
+    const std::size_t nQuery(m_aFirstSteps.size());
+    std::vector<Step> aSteps;
+    std::size_t nPosition(0);
+
+    while (nPosition < strQuery.length())
+    {
+        Step aStep;
+
+        aStep.nQuery = nQuery;
+        aStep.bDescendant = false;
+        aStep.bLast = false;
+
+        if (strQuery[nPosition] != '/')
+        {
+            throw new std::invalid_argument("Query step doesn't start with '/'.");
+        }
+
+        ++nPosition;
+
+        if (nPosition < strQuery.length() &&
+            strQuery[nPosition] == '/')
+        {
+            aStep.bDescendant = true;
+            ++nPosition;
+        }
+
+        std::size_t nEnd(strQuery.find_first_of("/[", nPosition));
+
+        if (nEnd == std::string::npos)
+        {
+            nEnd = strQuery.length();
+        }
+
+        if (nEnd <= nPosition)
+        {
+            throw new std::invalid_argument("Query step without name test.");
+        }
+
+        std::string strName(strQuery.substr(nPosition, nEnd - nPosition));
+
+        if (strName == "*")
+        {
+            aStep.nName = NAME_ANY;
+        }
+        else
+        {
+            std::unordered_map<std::string, std::size_t>::iterator iter = m_aNames.find(strName);
+
+            if (iter == m_aNames.end())
+            {
+                iter = m_aNames.insert(std::pair<std::string, std::size_t>(strName, m_aNames.size())).first;
+            }
+
+            aStep.nName = iter->second;
+        }
+
+        nPosition = nEnd;
+
+        while (nPosition < strQuery.length() &&
+               strQuery[nPosition] == '[')
+        {
+            Predicate aPredicate;
+
+            aPredicate.bHasValue = false;
+
+            if (nPosition + 1 >= strQuery.length() ||
+                strQuery[nPosition + 1] != '@')
+            {
+                throw new std::invalid_argument("Query predicate isn't an attribute test.");
+            }
+
+            nPosition += 2;
+            nEnd = strQuery.find_first_of("=]", nPosition);
+
+            if (nEnd == std::string::npos ||
+                nEnd <= nPosition)
+            {
+                throw new std::invalid_argument("Query predicate incomplete.");
+            }
+
+            aPredicate.strName = strQuery.substr(nPosition, nEnd - nPosition);
+            nPosition = nEnd;
+
+            if (strQuery[nPosition] == '=')
+            {
+                ++nPosition;
+
+                if (nPosition >= strQuery.length() ||
+                    (strQuery[nPosition] != '\'' &&
+                     strQuery[nPosition] != '"'))
+                {
+                    throw new std::invalid_argument("Query predicate value isn't quoted.");
+                }
+
+                nEnd = strQuery.find(strQuery[nPosition], nPosition + 1);
+
+                if (nEnd == std::string::npos)
+                {
+                    throw new std::invalid_argument("Query predicate incomplete.");
+                }
+
+                aPredicate.bHasValue = true;
+                aPredicate.strValue = strQuery.substr(nPosition + 1, nEnd - nPosition - 1);
+                nPosition = nEnd + 1;
+            }
+
+            if (nPosition >= strQuery.length() ||
+                strQuery[nPosition] != ']')
+            {
+                throw new std::invalid_argument("Query predicate incomplete.");
+            }
+
+            ++nPosition;
+
+            aStep.aPredicates.push_back(aPredicate);
+        }
+
+        aSteps.push_back(aStep);
+    }
+
+    aSteps.back().bLast = true;
+
+    m_aFirstSteps.push_back(m_aSteps.size());
+    m_aSteps.insert(m_aSteps.end(), aSteps.begin(), aSteps.end());
+
+    // The automaton is built anew for the changed queries.
+    m_aSets.clear();
+    m_aSetIds.clear();
+    m_aTransitions.clear();
+
+    return nQuery;
+}
+
+/**
+ * @brief Reads aReader to its end and calls aHandler for every element
+ *     that matches a query, once for every query it matches.
+ * @param[in] aHandler Receives the events of the matching element, from its
+ *     StartElement to its EndElement, when the EndElement is read, so for
+ *     nested matches, the inner one comes first.
+ * @retval Number of matches.
+ */
+std::size_t XPathMatcher::run(XMLEventReader& aReader, const MatchHandler& aHandler)
+{
+    const std::size_t nEmptySet(InternSet(std::vector<std::size_t>()));
+    std::vector<std::size_t> aStack;
+    std::vector<Capture> aCaptures;
+    std::vector<std::size_t> aMatches;
+    std::size_t nMatchCount(0);
+
+    aStack.push_back(InternSet(m_aFirstSteps));
+
+    while (aReader.hasNext() == true)
+    {
+        std::unique_ptr<XMLEvent> pEvent(aReader.nextEvent());
+
+        if (pEvent->isStartElement() == true)
+        {
+            aMatches.clear();
+
+            std::size_t nSet(Transit(aStack.back(), pEvent->asStartElement(), aMatches));
+
+            for (std::vector<std::size_t>::const_iterator iter = aMatches.begin();
+                 iter != aMatches.end();
+                 iter++)
+            {
+                aCaptures.push_back(Capture());
+                aCaptures.back().nQuery = *iter;
+                aCaptures.back().nDepth = aStack.size();
+            }
+
+            if (nSet == nEmptySet &&
+                aCaptures.empty() == true)
+            {
+                aReader.skipElement();
+                continue;
+            }
+
+            aStack.push_back(nSet);
+        }
+        else if (pEvent->isEndElement() == true)
+        {
+            if (aStack.size() > 1)
+            {
+                aStack.pop_back();
+            }
+        }
+
+        if (aCaptures.empty() == true)
+        {
+            continue;
+        }
+
+        for (std::size_t i = 0; i + 1 < aCaptures.size(); i++)
+        {
+            aCaptures[i].aEvents.push_back(pEvent->clone());
+        }
+
+        aCaptures.back().aEvents.push_back(std::move(pEvent));
+
+        // Captures are ordered by depth, so the ones that end are at the back.
+        while (aCaptures.empty() != true &&
+               aCaptures.back().nDepth >= aStack.size() &&
+               aCaptures.back().aEvents.back()->isEndElement() == true)
+        {
+            aHandler(aCaptures.back().nQuery, aCaptures.back().aEvents);
+            aCaptures.pop_back();
+            ++nMatchCount;
+        }
+    }
+
+    return nMatchCount;
+}
+
+/**
+ * @param[out] aMatches Receives the queries whose last step matches.
+ * @retval The set of steps active for the content of the element.
+ */
+std::size_t XPathMatcher::Transit(const std::size_t& nSet, StartElement& aStartElement, std::vector<std::size_t>& aMatches)
+{
+    std::size_t nName(NAME_OTHER);
+
+    {
+        std::unordered_map<std::string, std::size_t>::const_iterator iter = m_aNames.find(GetName(aStartElement.getName()));
+
+        if (iter != m_aNames.end())
+        {
+            nName = iter->second;
+        }
+    }
+
+    {
+        std::unordered_map<std::size_t, Transition>::const_iterator iter = m_aTransitions.at(nSet).find(nName);
+
+        if (iter != m_aTransitions.at(nSet).end())
+        {
+            aMatches.insert(aMatches.end(), iter->second.aMatches.begin(), iter->second.aMatches.end());
+            return iter->second.nTarget;
+        }
+    }
+
+    std::vector<std::size_t> aTarget;
+    bool bPredicates(false);
+
+    for (std::vector<std::size_t>::const_iterator iter = m_aSets.at(nSet).begin();
+         iter != m_aSets.at(nSet).end();
+         iter++)
+    {
+        const Step& aStep(m_aSteps.at(*iter));
+
+        if (aStep.bDescendant == true)
+        {
+            aTarget.push_back(*iter);
+        }
+
+        if (aStep.nName != NAME_ANY &&
+            aStep.nName != nName)
+        {
+            continue;
+        }
+
+        if (aStep.aPredicates.empty() != true)
+        {
+            bPredicates = true;
+
+            if (MatchPredicates(aStep, aStartElement) != true)
+            {
+                continue;
+            }
+        }
+
+        if (aStep.bLast == true)
+        {
+            aMatches.push_back(aStep.nQuery);
+        }
+        else
+        {
+            aTarget.push_back(*iter + 1);
+        }
+    }
+
+    std::sort(aTarget.begin(), aTarget.end());
+    aTarget.erase(std::unique(aTarget.begin(), aTarget.end()), aTarget.end());
+
+    std::size_t nTarget(InternSet(aTarget));
+
+    if (bPredicates != true)
+    {
+        Transition& aTransition(m_aTransitions.at(nSet)[nName]);
+
+        aTransition.nTarget = nTarget;
+        aTransition.aMatches = aMatches;
+    }
+
+    return nTarget;
+}
+
+bool XPathMatcher::MatchPredicates(const Step& aStep, StartElement& aStartElement)
+{
+    const std::shared_ptr<std::list<std::shared_ptr<Attribute>>> pAttributes(aStartElement.getAttributes());
+
+    for (std::vector<Predicate>::const_iterator iter = aStep.aPredicates.begin();
+         iter != aStep.aPredicates.end();
+         iter++)
+    {
+        bool bFound(false);
+
+        for (std::list<std::shared_ptr<Attribute>>::const_iterator iterAttribute = pAttributes->begin();
+             iterAttribute != pAttributes->end();
+             iterAttribute++)
+        {
+            if (GetName((*iterAttribute)->getName()) == iter->strName)
+            {
+                bFound = iter->bHasValue != true ||
+                         (*iterAttribute)->getValue() == iter->strValue;
+                break;
+            }
+        }
+
+        if (bFound != true)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::size_t XPathMatcher::InternSet(const std::vector<std::size_t>& aSteps)
+{
+    std::map<std::vector<std::size_t>, std::size_t>::const_iterator iter = m_aSetIds.find(aSteps);
+
+    if (iter != m_aSetIds.end())
+    {
+        return iter->second;
+    }
+
+    m_aSets.push_back(aSteps);
+    m_aTransitions.push_back(std::unordered_map<std::size_t, Transition>());
+    m_aSetIds.insert(std::pair<std::vector<std::size_t>, std::size_t>(aSteps, m_aSets.size() - 1));
+
+    return m_aSets.size() - 1;
+}
+
+std::string XPathMatcher::GetName(const QName& aName)
+{
+    if (aName.getPrefix().empty() == true)
+    {
+        return aName.getLocalPart();
+    }
+
+    return aName.getPrefix() + ":" + aName.getLocalPart();
+}
+
+}
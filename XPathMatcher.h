@@ -0,0 +1,114 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/XPathMatcher.h
+ * @brief Evaluates any number of queries of an XPath subset in a single
+ *     forward pass over an XMLEventReader.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#ifndef _CPPRSTAX_XPATHMATCHER_H
+#define _CPPRSTAX_XPATHMATCHER_H
+
+#include "XMLEventReader.h"
+#include "XMLEvent.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+namespace cpprstax
+{
+
+class XPathMatcher
+{
+public:
+    typedef std::function<void(const std::size_t& nQuery, std::vector<std::unique_ptr<XMLEvent>>& aEvents)> MatchHandler;
+
+public:
+    XPathMatcher();
+
+public:
+    std::size_t addQuery(const std::string& strQuery);
+    std::size_t run(XMLEventReader& aReader, const MatchHandler& aHandler);
+
+protected:
+    struct Predicate
+    {
+        std::string strName;
+        bool bHasValue;
+        std::string strValue;
+    };
+
+    /**
+     * @brief State of the automaton, which is waiting for this step of a
+     *     query to match.
+     */
+    struct Step
+    {
+        std::size_t nQuery;
+        bool bDescendant;
+        /** Last step of the query, so matching it matches the query. */
+        bool bLast;
+        /** Interned element name, or NAME_ANY. */
+        std::size_t nName;
+        std::vector<Predicate> aPredicates;
+    };
+
+    struct Transition
+    {
+        std::size_t nTarget;
+        std::vector<std::size_t> aMatches;
+    };
+
+    struct Capture
+    {
+        std::size_t nQuery;
+        std::size_t nDepth;
+        std::vector<std::unique_ptr<XMLEvent>> aEvents;
+    };
+
+    static const std::size_t NAME_ANY = SIZE_MAX;
+    static const std::size_t NAME_OTHER = SIZE_MAX - 1;
+
+protected:
+    std::size_t Transit(const std::size_t& nSet, StartElement& aStartElement, std::vector<std::size_t>& aMatches);
+    bool MatchPredicates(const Step& aStep, StartElement& aStartElement);
+    std::size_t InternSet(const std::vector<std::size_t>& aSteps);
+    static std::string GetName(const QName& aName);
+
+protected:
+    std::vector<Step> m_aSteps;
+    std::vector<std::size_t> m_aFirstSteps;
+    std::unordered_map<std::string, std::size_t> m_aNames;
+
+    /** Deterministic states, each a set of Steps, built while running. */
+    std::vector<std::vector<std::size_t>> m_aSets;
+    std::map<std::vector<std::size_t>, std::size_t> m_aSetIds;
+    /** Transitions by interned element name, only for those that don't
+      * depend on attribute predicates. */
+    std::vector<std::unordered_map<std::size_t, Transition>> m_aTransitions;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/cpprstax_index.cpp
+ * @brief Builds and queries element index files.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "ElementIndex.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+int Build(std::istream& aInput, const char* pIndexPath);
+int Query(std::istream& aInput, const char* pIndexPath, const std::string& strName, const char* pNumber);
+
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "CppRStAX Copyright (C) 2017-2026 Stephan Kreutzer\n"
+              << "This program comes with ABSOLUTELY NO WARRANTY.\n"
+              << "This is free software, and you are welcome to redistribute it\n"
+              << "under certain conditions. See the GNU Affero General Public License 3\n"
+              << "or any later version for details. Also, see the source code repository\n"
+              << "https://gitlab.com/publishing-systems/CppRStAX/ and\n"
+              << "the project website https://publishing-systems.org.\n"
+              << std::endl;
+
+    if (argc < 3)
+    {
+        std::cout << "Usage:\n\n"
+                  << "\tcpprstax_index <input-xml-file> <index-file>\n"
+                  << "\t\tWrites the index file for the input.\n\n"
+                  << "\tcpprstax_index <input-xml-file> <index-file> <element-name> [<n>]\n"
+                  << "\t\tLists the elements with that name, or prints the n-th of them (from 0).\n"
+                  << std::endl;
+        return 1;
+    }
+
+    std::ifstream aInput(argv[1], std::ios::in | std::ios::binary);
+
+    if (aInput.is_open() != true)
+    {
+        std::cout << "Couldn't open input file '" << argv[1] << "'." << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        if (argc == 3)
+        {
+            return Build(aInput, argv[2]);
+        }
+        else
+        {
+            return Query(aInput, argv[2], argv[3], argc >= 5 ? argv[4] : nullptr);
+        }
+    }
+    catch (std::exception* pException)
+    {
+        std::cout << "Exception: " << pException->what() << std::endl;
+        delete pException;
+        return -1;
+    }
+
+    return 0;
+}
+
+int Build(std::istream& aInput, const char* pIndexPath)
+{
+    std::ofstream aIndex(pIndexPath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (aIndex.is_open() != true)
+    {
+        std::cout << "Couldn't open index file '" << pIndexPath << "'." << std::endl;
+        return -1;
+    }
+
+    std::uint64_t nCount(cpprstax::ElementIndex::build(aInput, aIndex));
+
+    std::cout << "Indexed " << nCount << " elements." << std::endl;
+
+    return 0;
+}
+
+int Query(std::istream& aInput, const char* pIndexPath, const std::string& strName, const char* pNumber)
+{
+    std::ifstream aIndexStream(pIndexPath, std::ios::in | std::ios::binary);
+
+    if (aIndexStream.is_open() != true)
+    {
+        std::cout << "Couldn't open index file '" << pIndexPath << "'." << std::endl;
+        return -1;
+    }
+
+    cpprstax::ElementIndex aIndex(aIndexStream);
+
+    aInput.seekg(0, std::ios_base::end);
+
+    if (aInput.tellg() != aIndex.getInputSize())
+    {
+        std::cout << "Index file '" << pIndexPath << "' is out of date." << std::endl;
+        return -1;
+    }
+
+    std::vector<std::uint64_t> aElements(aIndex.getElementsByName(strName));
+
+    if (pNumber == nullptr)
+    {
+        for (std::vector<std::uint64_t>::iterator iter = aElements.begin();
+             iter != aElements.end();
+             iter++)
+        {
+            cpprstax::ElementIndex::Element aElement(aIndex.getElement(*iter));
+
+            std::cout << *iter << ": " << aElement.nBegin << "-" << aElement.nEnd
+                      << ", depth " << aElement.nDepth << std::endl;
+        }
+
+        return 0;
+    }
+
+    std::uint64_t nNumber(std::strtoull(pNumber, nullptr, 10));
+
+    if (nNumber >= aElements.size())
+    {
+        std::cout << "There are only " << aElements.size() << " elements named '" << strName << "'." << std::endl;
+        return 1;
+    }
+
+    cpprstax::ElementIndex::Element aElement(aIndex.getElement(aElements[nNumber]));
+    std::string strElement(aElement.nEnd - aElement.nBegin, '\0');
+
+    // Only the element itself is read, nothing before it.
+    aInput.clear();
+    aInput.seekg(aElement.nBegin);
+    aInput.read(&strElement[0], strElement.length());
+
+    std::cout << strElement << std::endl;
+
+    return 0;
+}
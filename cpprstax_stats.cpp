@@ -0,0 +1,351 @@
+/* Copyright (C) 2026 Stephan Kreutzer
+ *
+ * This file is part of CppRStAX.
+ *
+ * CppRStAX is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License version 3 or any later
+ * version of the license, as published by the Free Software Foundation.
+ *
+ * CppRStAX is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License 3 for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License 3
+ * along with CppRStAX. If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * @file $/cpprstax_stats.cpp
+ * @brief Profiles a document: element and attribute name counts, depth,
+ *     text sizes and the largest subtrees.
+ * @details Reads forward in batches with XMLEventReader::nextEvents(),
+ *     with comments and processing instructions masked, so they're skipped
+ *     without creating events. Names are interned once, after which a start
+ *     tag costs one hash lookup per name.
+ * @author Stephan Kreutzer
+ * @since 2026-10-18
+ */
+
+#include "XMLInputFactory.h"
+#include "StartElement.h"
+#include "Characters.h"
+#include "Attribute.h"
+#include "QName.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+struct NameStatistics
+{
+    std::string strName;
+    std::uint64_t nCount;
+    /** Bytes of the text directly in elements of this name. */
+    std::uint64_t nTextBytes;
+    std::uint64_t nMaxDepth;
+};
+
+struct Subtree
+{
+    /** Elements below the element. */
+    std::uint64_t nElements;
+    std::uint64_t nTextBytes;
+    std::size_t nName;
+    /** Number of the element among those with the same name, from 0, as
+      * the <n> argument of cpprstax_index. */
+    std::uint64_t nNumber;
+    std::uint32_t nDepth;
+
+    bool operator>(const Subtree& rhs) const
+    {
+        return nElements > rhs.nElements;
+    }
+};
+
+int Run(std::istream& aInput, const std::size_t& nTop);
+std::size_t Intern(const cpprstax::QName& aName, std::string& strBuffer, std::unordered_map<std::string, std::size_t>& aIds, std::vector<NameStatistics>& aStatistics);
+void Print(const std::string& strTitle, std::vector<NameStatistics> aStatistics, const bool& bElements);
+bool CompareCount(const NameStatistics& lhs, const NameStatistics& rhs);
+
+
+
+int main(int argc, char* argv[])
+{
+    std::cout << "CppRStAX Copyright (C) 2017-2026 Stephan Kreutzer\n"
+              << "This program comes with ABSOLUTELY NO WARRANTY.\n"
+              << "This is free software, and you are welcome to redistribute it\n"
+              << "under certain conditions. See the GNU Affero General Public License 3\n"
+              << "or any later version for details. Also, see the source code repository\n"
+              << "https://gitlab.com/publishing-systems/CppRStAX/ and\n"
+              << "the project website https://publishing-systems.org.\n"
+              << std::endl;
+
+    if (argc < 2)
+    {
+        std::cout << "Usage:\n\n"
+                  << "\tcpprstax_stats <input-xml-file> [<n>]\n"
+                  << "\t\tPrints statistics of the input, with the n largest subtrees (default 10).\n"
+                  << std::endl;
+        return 1;
+    }
+
+    std::size_t nTop(10);
+
+    if (argc >= 3)
+    {
+        nTop = std::strtoul(argv[2], nullptr, 10);
+    }
+
+    // A larger buffer than the default means fewer read() calls.
+    std::vector<char> aBuffer(1048576);
+    std::ifstream aInput;
+
+    aInput.rdbuf()->pubsetbuf(aBuffer.data(), aBuffer.size());
+    aInput.open(argv[1], std::ios::in | std::ios::binary);
+
+    if (aInput.is_open() != true)
+    {
+        std::cout << "Couldn't open input file '" << argv[1] << "'." << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        return Run(aInput, nTop);
+    }
+    catch (std::exception* pException)
+    {
+        std::cout << "Exception: " << pException->what() << std::endl;
+        delete pException;
+        return -1;
+    }
+
+    return 0;
+}
+
+int Run(std::istream& aInput, const std::size_t& nTop)
+{
+    cpprstax::XMLInputFactory aFactory;
+    std::unique_ptr<cpprstax::XMLEventReader> pReader(aFactory.createXMLEventReader(aInput));
+
+    pReader->setEventMask(cpprstax::XMLEventReader::MASK_COMMENT | cpprstax::XMLEventReader::MASK_PROCESSING_INSTRUCTION);
+
+    std::unordered_map<std::string, std::size_t> aElementIds;
+    std::vector<NameStatistics> aElements;
+    std::unordered_map<std::string, std::size_t> aAttributeIds;
+    std::vector<NameStatistics> aAttributes;
+    std::string strBuffer;
+
+    std::vector<Subtree> aOpenElements;
+    std::priority_queue<Subtree, std::vector<Subtree>, std::greater<Subtree>> aLargest;
+    // Per element name, the number of elements of that name seen so far.
+    std::vector<std::uint64_t> aNumbers;
+
+    std::uint64_t nElementCount(0);
+    std::uint64_t nAttributeCount(0);
+    std::uint64_t nTextBytes(0);
+    std::uint64_t nTextNodes(0);
+    std::uint64_t nMaxDepth(0);
+
+    const std::size_t BATCH_SIZE = 1024;
+    std::vector<std::unique_ptr<cpprstax::XMLEvent>> aEvents(BATCH_SIZE);
+    std::size_t nCount(0);
+
+    while ((nCount = pReader->nextEvents(aEvents.data(), BATCH_SIZE)) > 0)
+    {
+        for (std::size_t i = 0; i < nCount; i++)
+        {
+            cpprstax::XMLEvent& aEvent(*aEvents[i]);
+
+            if (aEvent.isStartElement() == true)
+            {
+                cpprstax::StartElement& aStartElement(aEvent.asStartElement());
+                std::size_t nName(Intern(aStartElement.getName(), strBuffer, aElementIds, aElements));
+
+                if (nName >= aNumbers.size())
+                {
+                    aNumbers.resize(nName + 1, 0);
+                }
+
+                ++nElementCount;
+
+                // Until the end tag, the counts at the start, from which the
+                // counts for the subtree are calculated then.
+                Subtree aSubtree = { nElementCount, nTextBytes, nName, aNumbers[nName], static_cast<std::uint32_t>(aOpenElements.size() + 1) };
+
+                ++aNumbers[nName];
+                aOpenElements.push_back(aSubtree);
+
+                NameStatistics& aStatistics(aElements[nName]);
+                ++aStatistics.nCount;
+                aStatistics.nMaxDepth = std::max<std::uint64_t>(aStatistics.nMaxDepth, aOpenElements.size());
+                nMaxDepth = std::max<std::uint64_t>(nMaxDepth, aOpenElements.size());
+
+                const std::shared_ptr<std::list<std::shared_ptr<cpprstax::Attribute>>> pAttributes(aStartElement.getAttributes());
+
+                for (std::list<std::shared_ptr<cpprstax::Attribute>>::const_iterator iter = pAttributes->begin();
+                     iter != pAttributes->end();
+                     iter++)
+                {
+                    NameStatistics& aAttribute(aAttributes[Intern((*iter)->getName(), strBuffer, aAttributeIds, aAttributes)]);
+
+                    ++aAttribute.nCount;
+                    aAttribute.nTextBytes += (*iter)->getValue().length();
+                    ++nAttributeCount;
+                }
+            }
+            else if (aEvent.isEndElement() == true)
+            {
+                if (aOpenElements.empty() == true)
+                {
+                    throw new std::runtime_error("End tag without start tag.");
+                }
+
+                Subtree& aSubtree(aOpenElements.back());
+
+                aSubtree.nElements = nElementCount - aSubtree.nElements;
+                aSubtree.nTextBytes = nTextBytes - aSubtree.nTextBytes;
+
+                if (nTop > 0)
+                {
+                    if (aLargest.size() < nTop)
+                    {
+                        aLargest.push(aSubtree);
+                    }
+                    else if (aSubtree > aLargest.top())
+                    {
+                        aLargest.pop();
+                        aLargest.push(aSubtree);
+                    }
+                }
+
+                aOpenElements.pop_back();
+            }
+            else if (aEvent.isCharacters() == true)
+            {
+                std::size_t nLength(aEvent.asCharacters().getData().length());
+
+                nTextBytes += nLength;
+                ++nTextNodes;
+
+                if (aOpenElements.empty() != true)
+                {
+                    aElements[aOpenElements.back().nName].nTextBytes += nLength;
+                }
+            }
+
+            aEvents[i].reset();
+        }
+    }
+
+    if (aOpenElements.empty() != true)
+    {
+        throw new std::runtime_error("Element not closed.");
+    }
+
+    std::cout << "Elements: " << nElementCount << " (" << aElements.size() << " names)\n"
+              << "Attributes: " << nAttributeCount << " (" << aAttributes.size() << " names)\n"
+              << "Text: " << nTextBytes << " bytes in " << nTextNodes << " nodes\n"
+              << "Maximum depth: " << nMaxDepth << "\n"
+              << std::endl;
+
+    Print("Elements by count:", aElements, true);
+    Print("Attributes by count:", aAttributes, false);
+
+    std::vector<Subtree> aSubtrees;
+
+    while (aLargest.empty() != true)
+    {
+        aSubtrees.push_back(aLargest.top());
+        aLargest.pop();
+    }
+
+    // The name and number are the <element-name> and <n> arguments of cpprstax_index.
+    std::cout << "Largest subtrees (elements below, text bytes, depth, name, number):\n";
+
+    for (std::vector<Subtree>::reverse_iterator iter = aSubtrees.rbegin();
+         iter != aSubtrees.rend();
+         iter++)
+    {
+        std::cout << "\t" << iter->nElements << "\t" << iter->nTextBytes << "\t" << iter->nDepth
+                  << "\t" << aElements[iter->nName].strName << "\t" << iter->nNumber << "\n";
+    }
+
+    std::cout << std::endl;
+
+    return 0;
+}
+
+/**
+ * @param[in,out] strBuffer Reused for the qualified name, so known names
+ *     don't cause an allocation.
+ * @retval Index of the name in aStatistics.
+ */
+std::size_t Intern(const cpprstax::QName& aName, std::string& strBuffer, std::unordered_map<std::string, std::size_t>& aIds, std::vector<NameStatistics>& aStatistics)
+{
+    strBuffer.clear();
+
+    if (aName.getPrefix().empty() != true)
+    {
+        strBuffer.append(aName.getPrefix());
+        strBuffer.push_back(':');
+    }
+
+    strBuffer.append(aName.getLocalPart());
+
+    std::unordered_map<std::string, std::size_t>::const_iterator iter = aIds.find(strBuffer);
+
+    if (iter != aIds.end())
+    {
+        return iter->second;
+    }
+
+    NameStatistics aNew = { strBuffer, 0, 0, 0 };
+
+    aStatistics.push_back(aNew);
+    aIds.insert(std::pair<std::string, std::size_t>(strBuffer, aStatistics.size() - 1));
+
+    return aStatistics.size() - 1;
+}
+
+void Print(const std::string& strTitle, std::vector<NameStatistics> aStatistics, const bool& bElements)
+{
+    std::sort(aStatistics.begin(),
+              aStatistics.end(),
+              CompareCount);
+
+    if (bElements == true)
+    {
+        std::cout << strTitle << " (count, text bytes, maximum depth, name)\n";
+    }
+    else
+    {
+        std::cout << strTitle << " (count, value bytes, name)\n";
+    }
+
+    for (std::vector<NameStatistics>::const_iterator iter = aStatistics.begin();
+         iter != aStatistics.end();
+         iter++)
+    {
+        std::cout << "\t" << iter->nCount << "\t" << iter->nTextBytes;
+
+        if (bElements == true)
+        {
+            std::cout << "\t" << iter->nMaxDepth;
+        }
+
+        std::cout << "\t" << iter->strName << "\n";
+    }
+
+    std::cout << std::endl;
+}
+
+bool CompareCount(const NameStatistics& lhs, const NameStatistics& rhs)
+{
+    return lhs.nCount > rhs.nCount;
+}